@@ -0,0 +1,114 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "SPI_Master.h"
+
+#ifdef SPI_STREAM_ISR
+static const unsigned char *SPI_streamPtr;          // Next byte to send
+static uint16_t SPI_streamSize;                     // Number of bytes left to send
+static void (*SPI_streamDone)( void );              // Called from the ISR when the stream is complete
+#endif
+
+/****************************************************************************
+Call this function to set up the SPI master and reset the display.
+****************************************************************************/
+void SPI_Master_Initialise( void )
+{
+  DDRB  |= (1<<PB2)|(1<<PB3)|(1<<PB5);              // CS, MOSI and SCK as outputs
+  PORTB |= (1<<PB2);                                // Display not selected
+  DDRD  |= (1<<SPI_DC_BIT)|(1<<SPI_RST_BIT);
+
+#ifdef SPI_STREAM_ISR
+  SPCR = (1<<SPE)|(1<<MSTR)|(1<<SPR0);              // Enable SPI master, mode 0, F_CPU / 16
+  SPSR = 0;
+#else
+  SPCR = (1<<SPE)|(1<<MSTR);                        // Enable SPI master, mode 0
+  SPSR = (1<<SPI2X);                                // F_CPU / 2
+#endif
+
+  // Reset pulse
+  PORTD |= (1<<SPI_RST_BIT);
+  _delay_ms(1);
+  PORTD &= ~(1<<SPI_RST_BIT);
+  _delay_ms(10);
+  PORTD |= (1<<SPI_RST_BIT);
+}
+
+/****************************************************************************
+Call this function to test if a stream is being sent.
+****************************************************************************/
+unsigned char SPI_Transceiver_Busy( void )
+{
+  return ( SPCR & (1<<SPIE) );                      // IF SPI Interrupt is enabled then the Transceiver is busy
+}
+
+// Select the display and set the D/C line from the control byte
+static void SPI_Begin_Message( uint8_t cmd )
+{
+  while ( SPI_Transceiver_Busy() );                 // Wait until the previous stream completed
+
+  if (cmd & 0x40) PORTD |= (1<<SPI_DC_BIT);
+  else            PORTD &= ~(1<<SPI_DC_BIT);
+  PORTB &= ~(1<<PB2);
+}
+
+/****************************************************************************
+Call this function to send a message. It's short (commands) or there's no
+interrupt mode, so it's sent right away.
+****************************************************************************/
+void SPI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char *msg, uint16_t msgSize )
+{
+  SPI_Begin_Message(cmd);
+
+  while (msgSize--) {
+    SPDR = *msg++;
+    while (!(SPSR & (1<<SPIF)));
+  }
+
+  PORTB |= (1<<PB2);
+}
+
+/****************************************************************************
+Call this function to send a message straight from the caller memory. With
+SPI_STREAM_ISR it returns as soon as the first byte is sent, and msg must not
+be modified until SPI_Transceiver_Busy() is false, or done is called (from the ISR).
+****************************************************************************/
+void SPI_Start_Stream( uint8_t cmd, const unsigned char *msg, uint16_t msgSize, void (*done)( void ) )
+{
+#ifdef SPI_STREAM_ISR
+  if (msgSize == 0) {
+    if (done) done();
+    return;
+  }
+
+  SPI_Begin_Message(cmd);
+  SPI_streamPtr  = msg + 1;
+  SPI_streamSize = msgSize - 1;
+  SPI_streamDone = done;
+  SPCR |= (1<<SPIE);
+  SPDR = *msg;
+#else
+  SPI_Start_Transceiver_With_Data(cmd, (unsigned char *) msg, msgSize);
+  if (done) done();
+#endif
+}
+
+#ifdef SPI_STREAM_ISR
+/****************************************************************************
+Sends the next byte of the stream, and releases the display after the last one.
+****************************************************************************/
+ISR(SPI_STC_vect)
+{
+  if (SPI_streamSize) {
+    SPDR = *SPI_streamPtr++;
+    SPI_streamSize--;
+  } else {
+    PORTB |= (1<<PB2);
+    SPCR &= ~(1<<SPIE);
+    if (SPI_streamDone) {
+      SPI_streamDone();
+      SPI_streamDone = 0;
+    }
+  }
+}
+#endif
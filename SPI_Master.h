@@ -0,0 +1,23 @@
+/****************************************************************************
+  Hardware SPI master for the SSD1306. Same interface as TWI_Master.
+  Messages start with the SSD1306 I2C control byte, which selects the D/C line:
+  0x00 for commands, 0x40 for data.
+
+  Pins: MOSI 11, SCK 13, CS 10 (the SS pin, it must be an output), D/C and RES below.
+****************************************************************************/
+#define SPI_DC_BIT    PD4     // Arduino pin 4
+#define SPI_RST_BIT   PD5     // Arduino pin 5
+
+// Streams are polled at F_CPU / 2 (8MHz) by default: a whole frame takes ~1.3ms.
+// Define SPI_STREAM_ISR to feed them from the SPI interrupt instead, so they run
+// in the background. An interrupt per byte needs ~50 cycles, so the clock drops
+// to F_CPU / 16 (1MHz) to leave the CPU some time: ~8ms per frame, 2/3 of it free.
+// #define SPI_STREAM_ISR
+
+/****************************************************************************
+  Function definitions
+****************************************************************************/
+void SPI_Master_Initialise( void );
+unsigned char SPI_Transceiver_Busy( void );
+void SPI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char *, uint16_t );
+void SPI_Start_Stream( uint8_t cmd, const unsigned char *, uint16_t, void (*)( void ) = 0 );
@@ -35,25 +35,11 @@
  *
  */
 
-#ifdef __AVR__
- #include <avr/pgmspace.h>
-#elif defined(ESP8266) || defined(ESP32)
- #include <pgmspace.h>
-#else
- #define pgm_read_byte(addr) \
-  (*(const unsigned char *)(addr)) ///< PROGMEM workaround for non-AVR
-#endif
-
-#if !defined(__ARM_ARCH) && !defined(ENERGIA) && !defined(ESP8266) && !defined(ESP32) && !defined(__arc__)
- #include <util/delay.h>
-#endif
-
+#include "hal.h"
 #include "SSD1306.h"
 
 // SOME DEFINES AND STATIC VARIABLES USED INTERNALLY -----------------------
 
-constexpr uint16_t WIRE_MAX = 342;
-
 #define ssd1306_swap(a, b) \
   (((a) ^= (b)), ((b) ^= (a)), ((a) ^= (b))) ///< No-temp-var swap operation
 
@@ -63,21 +49,55 @@ constexpr uint16_t WIRE_MAX = 342;
 // Because command calls are often grouped, SPI transaction and selection
 // must be started/ended in calling function for efficiency.
 // This is a private function, not exposed (see ssd1306_command() instead).
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::ssd1306_command1(uint8_t c) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::ssd1306_command1(uint8_t c) {
   uint8_t cmd = 0x00; // Co = 0, D/C = 0
-  TWI_Start_Transceiver_With_Data(cmd, &c, 1);
+  return ssd1306_send(cmd, &c, 1);
 }
 
 // Issue list of commands to SSD1306, same rules as above re: transactions.
+// The list must fit the I2C buffer (TWI_MAX_DATA), checked at compile time.
 // This is a private function, not exposed.
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::ssd1306_commandList(const uint8_t *c, uint8_t n) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+template <uint8_t N>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::ssd1306_commandList(const uint8_t (&c)[N]) {
+  static_assert(N <= TWI_MAX_DATA, "Command list bigger than the TWI buffer. Split it");
   uint8_t cmd = 0x00; // Co = 0, D/C = 0
-  uint8_t tmp[n];
+  uint8_t tmp[N];
+
+  memcpy_P(tmp, c, N);
+  return ssd1306_send(cmd, tmp);
+}
+
+// Send a message from an array, checking at compile time that it fits the
+// I2C buffer. Bigger ones go through ssd1306_stream().
+// This is a private function, not exposed.
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+template <uint8_t N>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::ssd1306_send(uint8_t cmd, uint8_t (&data)[N]) {
+  static_assert(N <= TWI_MAX_DATA, "Message bigger than the TWI buffer. Stream it");
+  return ssd1306_send(cmd, data, N);
+}
 
-  uint8_t * tmpptr = static_cast<uint8_t *>(memcpy_P(tmp, c, n));
-  TWI_Start_Transceiver_With_Data(cmd, tmpptr, n);
+// Send one message (control byte + data) through the transport and count
+// the bytes that go through the bus, including the I2C address byte.
+// Returns false, and counts nothing, when the transport refused it.
+// This is a private function, not exposed.
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::ssd1306_send(uint8_t cmd, uint8_t *data, uint16_t n) {
+  if (!TRANSPORT::send(cmd, data, n)) return false;
+  bytes_sent += n + TRANSPORT::OVERHEAD;
+  return true;
+}
+
+// Same as above, but the bytes are sent straight from data, and it may
+// return before the message is sent (I2C, or SPI_STREAM_ISR). data must
+// not change until the transfer is done (see waitDisplay()).
+// This is a private function, not exposed.
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::ssd1306_stream(uint8_t cmd, const uint8_t *data, uint16_t n) {
+  TRANSPORT::stream(cmd, data, n);
+  bytes_sent += n + TRANSPORT::OVERHEAD;
 }
 
 // ALLOCATE & INIT DISPLAY -------------------------------------------------
@@ -117,10 +137,17 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::ssd1306_commandList(const uint8_t *c, uint
             proceeding.
     @note   MUST call this function before any drawing or updates!
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::begin(uint8_t vcs, uint8_t addr) {
 
   clearDisplay();
+  bytes_sent = 0;
+#ifdef SSD1306_BAND_PAGES
+  band_page = 0;
+#endif
+#ifdef SSD1306_DELTA_FLUSH
+  frames_to_refresh = 0;  // first frame is always a full one
+#endif
 
   vccstate = vcs;
 
@@ -132,7 +159,7 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
     // function if it has unusual circumstances (e.g. TWI variants that
     // can accept different SDA/SCL pins, or if two SSD1306 instances
     // with different addresses -- only a single begin() is needed).
-  TWI_Master_Initialise();
+  TRANSPORT::begin();
 
   // Init sequence
   static const uint8_t PROGMEM init1[] = {
@@ -140,7 +167,7 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
     SSD1306_SETDISPLAYCLOCKDIV,           // 0xD5
     0x80,                                 // the suggested ratio 0x80
     SSD1306_SETMULTIPLEX };               // 0xA8
-  ssd1306_commandList(init1, sizeof(init1));
+  if (!ssd1306_commandList(init1)) return false;
   ssd1306_command1(HEIGHT - 1);
 
   static const uint8_t PROGMEM init2[] = {
@@ -148,7 +175,7 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
     0x0,                                  // no offset
     SSD1306_SETSTARTLINE | 0x0,           // line #0
     SSD1306_CHARGEPUMP };                 // 0x8D
-  ssd1306_commandList(init2, sizeof(init2));
+  if (!ssd1306_commandList(init2)) return false;
 
   ssd1306_command1((vccstate == SSD1306_EXTERNALVCC) ? 0x10 : 0x14);
 
@@ -157,7 +184,7 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
     0x00,                                 // 0x0 act like ks0108
     SSD1306_SEGREMAP | 0x1,
     SSD1306_COMSCANDEC };
-  ssd1306_commandList(init3, sizeof(init3));
+  if (!ssd1306_commandList(init3)) return false;
 
   if((WIDTH == 128) && (HEIGHT == 32)) {
     static const uint8_t PROGMEM init4a[] = {
@@ -165,20 +192,20 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
       0x02,
       SSD1306_SETCONTRAST,                // 0x81
       0x8F };
-    ssd1306_commandList(init4a, sizeof(init4a));
+    if (!ssd1306_commandList(init4a)) return false;
   } else if((WIDTH == 128) && (HEIGHT == 64)) {
     static const uint8_t PROGMEM init4b[] = {
       SSD1306_SETCOMPINS,                 // 0xDA
       0x12,
       SSD1306_SETCONTRAST };              // 0x81
-    ssd1306_commandList(init4b, sizeof(init4b));
+    if (!ssd1306_commandList(init4b)) return false;
     ssd1306_command1((vccstate == SSD1306_EXTERNALVCC) ? 0x9F : 0xCF);
   } else if((WIDTH == 96) && (HEIGHT == 16)) {
     static const uint8_t PROGMEM init4c[] = {
       SSD1306_SETCOMPINS,                 // 0xDA
       0x2,    // ada x12
       SSD1306_SETCONTRAST };              // 0x81
-    ssd1306_commandList(init4c, sizeof(init4c));
+    if (!ssd1306_commandList(init4c)) return false;
     ssd1306_command1((vccstate == SSD1306_EXTERNALVCC) ? 0x10 : 0xAF);
   } else {
     // Other screen varieties -- TBD
@@ -193,7 +220,7 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
     SSD1306_NORMALDISPLAY,               // 0xA6
     SSD1306_DEACTIVATE_SCROLL,
     SSD1306_DISPLAYON };                 // Main screen turn on
-  ssd1306_commandList(init5, sizeof(init5));
+  if (!ssd1306_commandList(init5)) return false;
 
   return true; // Success
 }
@@ -215,9 +242,10 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::begin(uint8_t vcs, uint8_t addr) {
             Follow up with a call to display(), or with other graphics
             commands as needed by one's own application.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::drawPixel(int16_t x, int16_t y, uint16_t color) {
-  if((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT)) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  y -= bandTop();
+  if((x >= 0) && (x < WIDTH) && (y >= 0) && (y < BUFFER_HEIGHT)) {
     // Pixel is in-bounds. Rotate coordinates if needed.
     switch(color) {
      case SSD1306_WHITE:   buffer[x + (y/8)*WIDTH] |=  (1 << (y&7)); break;
@@ -234,9 +262,9 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::drawPixel(int16_t x, int16_t y, uint16_t c
             Follow up with a call to display(), or with other graphics
             commands as needed by one's own application.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::clearDisplay(void) {
-  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::clearDisplay(void) {
+  memset(buffer, 0, sizeof(buffer));
 }
 
 /*!
@@ -255,23 +283,24 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::clearDisplay(void) {
             Follow up with a call to display(), or with other graphics
             commands as needed by one's own application.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::drawFastVLine(
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::drawFastVLine(
   int16_t x, int16_t y, int16_t h, uint16_t color) {
   drawFastVLineInternal(x, y, h, color);
 }
 
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::drawFastVLineInternal(
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::drawFastVLineInternal(
   int16_t x, int16_t __y, int16_t __h, uint16_t color) {
 
+  __y -= bandTop();
   if((x >= 0) && (x < WIDTH)) { // X coord in bounds?
     if(__y < 0) { // Clip top
       __h += __y;
       __y = 0;
     }
-    if((__y + __h) > HEIGHT) { // Clip bottom
-      __h = (HEIGHT - __y);
+    if((__y + __h) > BUFFER_HEIGHT) { // Clip bottom
+      __h = (BUFFER_HEIGHT - __y);
     }
     if(__h > 0) { // Proceed only if height is now positive
       // this display doesn't need ints for coordinates,
@@ -345,20 +374,23 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::drawFastVLineInternal(
   } // endif x in bounds
 }
 
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::clearRect(uint8_t x, uint8_t y, uint8_t w , uint8_t h) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::clearRect(uint8_t x, uint8_t y, uint8_t w , uint8_t h) {
   for (int16_t i=x; i<x+w; i++) {
     drawFastVLineInternal(i, y, h, 0);
   }
 }
 
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::drawBitmap(int16_t x, int16_t y,
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::drawBitmap(int16_t x, int16_t y,
   const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
 
     int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
     uint8_t byte = 0;
 
+    // Nothing to draw in this band
+    if(y + h <= bandTop() || y >= bandTop() + BUFFER_HEIGHT) return;
+
     for(int16_t j=0; j<h; j++, y++) {
         for(int16_t i=0; i<w; i++) {
             if(i & 7) byte <<= 1;
@@ -379,9 +411,10 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::drawBitmap(int16_t x, int16_t y,
     @note   Reads from buffer contents; may not reflect current contents of
             screen if display() has not been called.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-bool Adafruit_SSD1306<WIDTH, HEIGHT>::getPixel(int16_t x, int16_t y) {
-  if((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT)) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::getPixel(int16_t x, int16_t y) {
+  y -= bandTop();
+  if((x >= 0) && (x < WIDTH) && (y >= 0) && (y < BUFFER_HEIGHT)) {
     // Pixel is in-bounds. Rotate coordinates if needed.
     return (buffer[x + (y / 8) * WIDTH] & (1 << (y & 7)));
   }
@@ -393,8 +426,8 @@ bool Adafruit_SSD1306<WIDTH, HEIGHT>::getPixel(int16_t x, int16_t y) {
     @return Pointer to an unsigned 8-bit array, column-major, columns padded
             to full byte boundary if needed.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-uint8_t *Adafruit_SSD1306<WIDTH, HEIGHT>::getBuffer(void) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+uint8_t *Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::getBuffer(void) {
   return buffer;
 }
 
@@ -407,28 +440,146 @@ uint8_t *Adafruit_SSD1306<WIDTH, HEIGHT>::getBuffer(void) {
             called. Call after each graphics command, or after a whole set
             of graphics commands, as best needed by one's own application.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::display(void) {
-  static const uint8_t PROGMEM dlist1[] = {
-    SSD1306_PAGEADDR,
-    0,                         // Page start address
-    0xFF,                      // Page end (not really, but works here)
-    SSD1306_COLUMNADDR,
-    0 };                       // Column start address
-  ssd1306_commandList(dlist1, sizeof(dlist1));
-  ssd1306_command1(WIDTH - 1); // Column end address
-
-  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
-  uint8_t *ptr   = buffer;
-  uint8_t cmd = 0x40;
-  while(count >= (WIRE_MAX)){
-    TWI_Start_Transceiver_With_Data(cmd, ptr, WIRE_MAX);
-    count -= (WIRE_MAX);
-    ptr += (WIRE_MAX);
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::display(void) {
+#ifdef SSD1306_DELTA_FLUSH
+  // Delta mode: sign every segment of each page and only send the runs of
+  // segments whose signature changed. A full frame is sent every
+  // SSD1306_DELTA_REFRESH frames, to heal any signature collision.
+  bool full = frames_to_refresh == 0;
+  if (bandTop() + BUFFER_HEIGHT >= HEIGHT) { // last band of the frame
+    frames_to_refresh = full ? SSD1306_DELTA_REFRESH : frames_to_refresh - 1;
   }
-  if(count > 0) {
-    TWI_Start_Transceiver_With_Data(cmd, ptr, count);
+
+  constexpr uint8_t segments = WIDTH / SSD1306_SEGMENT_SIZE;
+  uint8_t *ptr = buffer;
+  uint16_t *sig = segment_sig + bandTop() / 8 * segments;
+
+  for (uint8_t page = bandTop() / 8; page < bandTop() / 8 + BUFFER_PAGES; page++) {
+    int8_t run_start = -1;
+
+    for (uint8_t s = 0; s <= segments; s++) {
+      bool dirty = false;
+
+      if (s < segments) {
+        // Fletcher-16 (mod 256). Cheap on AVR and sensitive to byte order
+        uint8_t sum1 = 0;
+        uint8_t sum2 = 0;
+        for (uint8_t i = 0; i < SSD1306_SEGMENT_SIZE; i++) {
+          sum1 += *ptr++;
+          sum2 += sum1;
+        }
+
+        uint16_t hash = sum2 << 8 | sum1;
+        dirty = full || hash != *sig;
+        *sig++ = hash;
+      }
+
+      if (dirty && run_start < 0) {
+        run_start = s;
+      } else if (!dirty && run_start >= 0) {
+        displayWindow(page, run_start * SSD1306_SEGMENT_SIZE, s * SSD1306_SEGMENT_SIZE - 1);
+        run_start = -1;
+      }
+    }
   }
+#else
+  uint8_t first_page = bandTop() / 8;
+  uint8_t window[] = {
+    SSD1306_PAGEADDR,
+    first_page,                           // Page start address
+    (uint8_t) (first_page + BUFFER_PAGES - 1), // Page end address
+    SSD1306_COLUMNADDR,
+    0,                                    // Column start address
+    WIDTH - 1 };                          // Column end address
+  ssd1306_send(0x00, window);
+
+  // The whole buffer goes in a single message, streamed from the buffer
+  // while the next frame is being computed
+  ssd1306_stream(0x40, buffer, sizeof(buffer));
+#endif
+}
+
+#ifdef SSD1306_BAND_PAGES
+/*!
+    @brief  Start drawing a frame in band mode. The buffer only holds a band
+            of SSD1306_BAND_PAGES pages, so the whole frame is drawn once
+            per band:
+              display.firstPage();
+              do { ...draw... } while (display.nextPage());
+            Drawing functions clip to the current band.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::firstPage(void) {
+  waitDisplay();
+  clearDisplay();
+  band_page = 0;
+}
+
+/*!
+    @brief  Send the current band and move to the next one.
+    @return true if there's another band to draw, false when the frame is
+            complete. The last band is still being sent on return.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+bool Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::nextPage(void) {
+  display();
+  if (band_page + BUFFER_PAGES >= (HEIGHT + 7) / 8) return false;
+
+  // The band is streamed from the buffer. Wait before reusing it
+  waitDisplay();
+  clearDisplay();
+  band_page += BUFFER_PAGES;
+  return true;
+}
+
+/*!
+    @brief  First page held in the buffer.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+uint8_t Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::getPage(void) {
+  return band_page;
+}
+#endif
+
+/*!
+    @brief  Wait until the last display() finished sending the buffer.
+            Call before changing the buffer contents, otherwise the
+            changes might show up mid frame.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::waitDisplay(void) {
+  while (TRANSPORT::busy());
+}
+
+// Send a range of columns of a single page.
+// This is a private function, not exposed.
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::displayWindow(uint8_t page, uint8_t col_start, uint8_t col_end) {
+  uint8_t window[] = {
+    SSD1306_PAGEADDR,
+    page,                      // Page start address
+    page,                      // Page end address
+    SSD1306_COLUMNADDR,
+    col_start,                 // Column start address
+    col_end };                 // Column end address
+  ssd1306_send(0x00, window);
+  ssd1306_stream(0x40, buffer + (page - bandTop() / 8) * WIDTH + col_start, col_end - col_start + 1);
+}
+
+/*!
+    @brief  Bytes sent through the bus since begin() or the last
+            resetBytesSent(), including addressing and commands.
+    @return Byte count.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+uint32_t Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::getBytesSent(void) {
+  return bytes_sent;
+}
+
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::resetBytesSent(void) {
+  bytes_sent = 0;
 }
 
 // OTHER HARDWARE SETTINGS -------------------------------------------------
@@ -446,7 +597,20 @@ void Adafruit_SSD1306<WIDTH, HEIGHT>::display(void) {
             enabled, drawing SSD1306_BLACK (value 0) pixels will actually draw white,
             SSD1306_WHITE (value 1) will draw black.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
-void Adafruit_SSD1306<WIDTH, HEIGHT>::invertDisplay(bool i) {
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::invertDisplay(bool i) {
   ssd1306_command1(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
 }
+
+/*!
+    @brief  Set the display contrast (brightness).
+    @param  contrast
+            0 (dimmest) to 255. begin() sets 0xCF (0x9F with external VCC).
+    @return None (void).
+    @note   This has an immediate effect on the display.
+*/
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT>
+void Adafruit_SSD1306<WIDTH, HEIGHT, TRANSPORT>::setContrast(uint8_t contrast) {
+  uint8_t c[] = { SSD1306_SETCONTRAST, contrast };
+  ssd1306_send(0x00, c);
+}
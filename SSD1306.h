@@ -24,7 +24,9 @@
 #ifndef _Adafruit_SSD1306_H_
 #define _Adafruit_SSD1306_H_
 
+#include "hal.h"
 #include "TWI_Master.h"
+#include "SPI_Master.h"
 #include "string.h"
 #include "constants.h"
 
@@ -77,11 +79,45 @@
 #define SSD1306_ACTIVATE_SCROLL                      0x2F ///< Start scroll
 #define SSD1306_SET_VERTICAL_SCROLL_AREA             0xA3 ///< Set scroll range
 
+#define SSD1306_SEGMENT_SIZE        32   ///< Bytes per delta flush segment
+#define SSD1306_DELTA_REFRESH       32   ///< Frames between full refreshes in delta mode
+
+/*!
+    @brief  Transport policies: how messages reach the display.
+            cmd is the I2C control byte: 0x00 for commands, 0x40 for data.
+            send() copies the message, and returns false if it wasn't
+            sent (too big). stream() sends it from the caller memory and
+            may return before it's done (see busy()).
+*/
+struct I2CTransport {
+  static constexpr uint8_t OVERHEAD = 2;    ///< Address and control bytes
+  static void begin(void) { TWI_Master_Initialise(); }
+  static bool send(uint8_t cmd, uint8_t *data, uint16_t n) { return TWI_Start_Transceiver_With_Data(cmd, data, n); }
+  static void stream(uint8_t cmd, const uint8_t *data, uint16_t n) { TWI_Start_Stream(cmd, data, n); }
+  static bool busy(void) { return TWI_Transceiver_Busy(); }
+};
+
+struct SPITransport {
+  static constexpr uint8_t OVERHEAD = 0;    ///< The control byte is the D/C line
+  static void begin(void) { SPI_Master_Initialise(); }
+  static bool send(uint8_t cmd, uint8_t *data, uint16_t n) { SPI_Start_Transceiver_With_Data(cmd, data, n); return true; }
+  static void stream(uint8_t cmd, const uint8_t *data, uint16_t n) { SPI_Start_Stream(cmd, data, n); }
+  static bool busy(void) { return SPI_Transceiver_Busy(); }
+};
+
+#if defined(HOST)
+typedef HostTransport SSD1306_TRANSPORT;
+#elif defined(SSD1306_SPI)
+typedef SPITransport SSD1306_TRANSPORT;
+#else
+typedef I2CTransport SSD1306_TRANSPORT;
+#endif
+
 /*! 
     @brief  Class that stores state and functions for interacting with
             SSD1306 OLED displays.
 */
-template <uint8_t WIDTH, uint8_t HEIGHT>
+template <uint8_t WIDTH, uint8_t HEIGHT, class TRANSPORT = SSD1306_TRANSPORT>
 class Adafruit_SSD1306 {
  public:
   Adafruit_SSD1306() = default;
@@ -91,6 +127,12 @@ class Adafruit_SSD1306 {
   bool      begin(uint8_t switchvcc=SSD1306_SWITCHCAPVCC,
                  uint8_t i2caddr=0);
   void         display(void);
+  void         waitDisplay(void);
+#ifdef SSD1306_BAND_PAGES
+  void         firstPage(void);
+  bool         nextPage(void);
+  uint8_t      getPage(void);
+#endif
   void         clearDisplay(void);
   void         invertDisplay(bool i);
   void         drawPixel(int16_t x, int16_t y, uint16_t color);
@@ -99,15 +141,40 @@ class Adafruit_SSD1306 {
   uint8_t     *getBuffer(void);
   void clearRect(uint8_t, uint8_t, uint8_t, uint8_t);
   void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  uint32_t     getBytesSent(void);
+  void         resetBytesSent(void);
+  void         setContrast(uint8_t contrast);
 
  private:
   void         drawFastVLineInternal(int16_t x, int16_t y, int16_t h,
                  uint16_t color);
-  void         ssd1306_command1(uint8_t c);
-  void         ssd1306_commandList(const uint8_t *c, uint8_t n);
+  bool         ssd1306_command1(uint8_t c);
+  template <uint8_t N>
+  bool         ssd1306_commandList(const uint8_t (&c)[N]);
+  template <uint8_t N>
+  bool         ssd1306_send(uint8_t cmd, uint8_t (&data)[N]);
+  bool         ssd1306_send(uint8_t cmd, uint8_t *data, uint16_t n);
+  void         ssd1306_stream(uint8_t cmd, const uint8_t *data, uint16_t n);
+  void         displayWindow(uint8_t page, uint8_t col_start, uint8_t col_end);
 
-  uint8_t     buffer[WIDTH * ((HEIGHT + 7) / 8)];
+#ifdef SSD1306_BAND_PAGES
+  // Band mode: the buffer only holds SSD1306_BAND_PAGES pages, starting at band_page
+  static constexpr uint8_t BUFFER_PAGES = SSD1306_BAND_PAGES;
+  uint8_t      band_page;
+  uint8_t      bandTop(void) { return band_page * 8; }
+#else
+  static constexpr uint8_t BUFFER_PAGES = (HEIGHT + 7) / 8;
+  uint8_t      bandTop(void) { return 0; }
+#endif
+  static constexpr uint8_t BUFFER_HEIGHT = BUFFER_PAGES * 8;
+
+  uint8_t     buffer[WIDTH * BUFFER_PAGES];
   int8_t       i2caddr, vccstate, page_end;
+  uint32_t     bytes_sent;
+#ifdef SSD1306_DELTA_FLUSH
+  uint16_t     segment_sig[WIDTH * ((HEIGHT + 7) / 8) / SSD1306_SEGMENT_SIZE];
+  uint8_t      frames_to_refresh;
+#endif
 };
 
 template class Adafruit_SSD1306<SCREEN_WIDTH, SCREEN_HEIGHT>;
@@ -52,6 +52,9 @@ static unsigned char TWI_buf[ TWI_BUFFER_SIZE ];    // Transceiver buffer
 static uint16_t TWI_msgSize;                   // Number of bytes to be transmitted.
 static unsigned char TWI_state = TWI_NO_STATE;      // State byte. Default set to TWI_NO_STATE.
 static unsigned char lastTransOK; 
+static const unsigned char *TWI_streamPtr;          // Data streamed after TWI_buf, without copying it
+static uint16_t TWI_streamSize;                     // Number of bytes left to stream
+static void (*TWI_streamDone)( void );              // Called from the ISR when the stream is complete
 
 /****************************************************************************
 Call this function to set up the TWI master to its initial standby state.
@@ -91,12 +94,21 @@ Call this function to send a prepared message. The first byte must contain the s
 read/write bit. Consecutive bytes contain the data to be sent, or empty locations for data to be read
 from the slave. Also include how many bytes that should be sent/read including the address byte.
 The function will hold execution (loop) until the TWI_ISR has completed with the previous operation,
-then initialize the next operation and return.
+then initialize the next operation and return TRUE.
+Messages longer than TWI_MAX_DATA don't fit the buffer and aren't sent: it returns FALSE, and
+TWI_Get_State_Info() returns TWI_MSG_TOO_LONG. Stream them instead.
 ****************************************************************************/
-void TWI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char *msg, uint16_t msgSize )
+unsigned char TWI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char *msg, uint16_t msgSize )
 {
   while ( TWI_Transceiver_Busy() );             // Wait until TWI is ready for next transmission.
 
+  if ( msgSize > TWI_MAX_DATA )                 // Would overrun TWI_buf
+  {
+    lastTransOK = 0;
+    TWI_state   = TWI_MSG_TOO_LONG;
+    return FALSE;
+  }
+
   TWI_msgSize = msgSize + 2;                        // Number of data to transmit.
   TWI_buf[0]  = TWI_ADDR;                         // Store slave address with R/W setting.
   TWI_buf[1] = cmd;
@@ -105,12 +117,40 @@ void TWI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char *msg, uint16_t
     TWI_buf[i] = *msg++;
   }
 
+  TWI_streamSize    = 0;
+  TWI_streamDone    = 0;
   lastTransOK = 0;      
   TWI_state         = TWI_NO_STATE ;
   TWCR = (1<<TWEN)|                             // TWI Interface enabled.
          (1<<TWIE)|(1<<TWINT)|                  // Enable TWI Interrupt and clear the flag.
          (0<<TWEA)|(1<<TWSTA)|(0<<TWSTO)|       // Initiate a START condition.
          (0<<TWWC);                             //
+  return TRUE;
+}
+
+/****************************************************************************
+Call this function to send a message straight from the caller memory. The ISR feeds the bytes
+from msg, so nothing is copied and the function returns as soon as the transmission starts.
+The caller must not modify msg until TWI_Transceiver_Busy() is false, or done is called (from
+the ISR). Like the function above, it will hold execution until the previous operation completed.
+****************************************************************************/
+void TWI_Start_Stream( uint8_t cmd, const unsigned char *msg, uint16_t msgSize, void (*done)( void ) )
+{
+  while ( TWI_Transceiver_Busy() );             // Wait until TWI is ready for next transmission.
+
+  TWI_msgSize = 2;                              // Only address and command come from the buffer
+  TWI_buf[0]  = TWI_ADDR;
+  TWI_buf[1]  = cmd;
+  TWI_streamPtr     = msg;
+  TWI_streamSize    = msgSize;
+  TWI_streamDone    = done;
+
+  lastTransOK = 0;
+  TWI_state         = TWI_NO_STATE ;
+  TWCR = (1<<TWEN)|                             // TWI Interface enabled.
+         (1<<TWIE)|(1<<TWINT)|                  // Enable TWI Interrupt and clear the flag.
+         (0<<TWEA)|(1<<TWSTA)|(0<<TWSTO)|       // Initiate a START condition.
+         (0<<TWWC);                             //
 }
 
 /****************************************************************************
@@ -170,9 +210,16 @@ ISR(TWI_vect)
       TWI_bufPtr = 0;                                     // Set buffer pointer to the TWI Address location
     case TWI_MTX_ADR_ACK:       // SLA+W has been transmitted and ACK received
     case TWI_MTX_DATA_ACK:      // Data byte has been transmitted and ACK received
-      if (TWI_bufPtr < TWI_msgSize)
+      if (TWI_bufPtr < TWI_msgSize || TWI_streamSize)
       {
-        TWDR = TWI_buf[TWI_bufPtr++];
+        if (TWI_bufPtr < TWI_msgSize)
+        {
+          TWDR = TWI_buf[TWI_bufPtr++];
+        }else                  // Buffer sent, continue with the streamed data
+        {
+          TWDR = *TWI_streamPtr++;
+          TWI_streamSize--;
+        }
         TWCR = (1<<TWEN)|                                 // TWI Interface enabled
                (1<<TWIE)|(1<<TWINT)|                      // Enable TWI Interrupt and clear the flag to send byte
                (0<<TWEA)|(0<<TWSTA)|(0<<TWSTO)|           //
@@ -184,6 +231,11 @@ ISR(TWI_vect)
                (0<<TWIE)|(1<<TWINT)|                      // Disable TWI Interrupt and clear the flag
                (0<<TWEA)|(0<<TWSTA)|(1<<TWSTO)|           // Initiate a STOP condition.
                (0<<TWWC);                                 //
+        if (TWI_streamDone)
+        {
+          TWI_streamDone();
+          TWI_streamDone = 0;
+        }
       }
       break;
     case TWI_MRX_DATA_ACK:      // Data byte has been received and ACK transmitted
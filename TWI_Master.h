@@ -47,7 +47,9 @@
 /****************************************************************************
   TWI Status/Control register definitions
 ****************************************************************************/
-constexpr uint16_t TWI_BUFFER_SIZE = 344;   // Set this to the largest message size that will be sent including address byte.
+constexpr uint16_t TWI_BUFFER_SIZE = 16;    // Set this to the largest message size that will be sent including address byte.
+                                            // Bigger messages (the frame buffer) are streamed with TWI_Start_Stream
+constexpr uint16_t TWI_MAX_DATA = TWI_BUFFER_SIZE - 2;    // Data bytes TWI_Start_Transceiver_With_Data takes, after address and command
 #define TWI_FREQ 400000UL
 #define TWI_ADDR 0x78 // 0x3C << 1
 
@@ -57,7 +59,8 @@ constexpr uint16_t TWI_BUFFER_SIZE = 344;   // Set this to the largest message s
 void TWI_Master_Initialise( void );
 unsigned char TWI_Transceiver_Busy( void );
 unsigned char TWI_Get_State_Info( void );
-void TWI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char * , uint16_t);
+unsigned char TWI_Start_Transceiver_With_Data( uint8_t cmd, unsigned char * , uint16_t);
+void TWI_Start_Stream( uint8_t cmd, const unsigned char *, uint16_t, void (*)( void ) = 0 );
 void TWI_Start_Transceiver( void );
 unsigned char TWI_Get_Data_From_Transceiver( unsigned char *, unsigned char );
 
@@ -111,3 +114,4 @@ unsigned char TWI_Get_Data_From_Transceiver( unsigned char *, unsigned char );
 // TWI Miscellaneous status codes
 #define TWI_NO_STATE               0xF8  // No relevant state information available; TWINT = �0�
 #define TWI_BUS_ERROR              0x00  // Bus error due to an illegal START or STOP condition
+#define TWI_MSG_TOO_LONG           0xFE  // Message bigger than TWI_MAX_DATA, not sent (driver code, not from TWSR)
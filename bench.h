@@ -0,0 +1,43 @@
+#ifndef _bench_h
+#define _bench_h
+
+/*
+  Benchmark of the render and update stages. Built with BENCHMARK, the
+  firmware runs the scenarios below instead of the game, and marks the
+  stages by writing to the general purpose I/O registers (1 cycle each):
+    GPIOR0  BENCH_BEGIN | stage when it starts, stage when it ends
+    GPIOR1  scenario index, when it starts
+    GPIOR2  BENCH_DONE after the last scenario
+  bench/bench.c runs it under simavr and counts the cycles in between.
+
+  Plain defines only: bench.c includes this file too.
+*/
+
+// Stages, in report order
+#define BENCH_UPDATE_ENTITIES   0
+#define BENCH_RENDER_MAP        1
+#define BENCH_RENDER_ENTITIES   2
+#define BENCH_DISPLAY_LIST      3     // Only with SSD1306_BAND_PAGES
+#define BENCH_RENDER_GUN        4
+#define BENCH_DISPLAY           5     // Until the frame is on the display
+#define BENCH_BLOCK_LOOKUP      6     // Map lookups over every cell, in the first scenario:
+#define BENCH_WALL_LOOKUP       7     //   getBlockAt() == E_WALL, isWall()
+#define BENCH_FIELD_LOOKUP      8     //   and getDistanceAt()
+#define BENCH_STAGES            9
+
+#define BENCH_BEGIN             0x80
+#define BENCH_DONE              0xFF
+
+#define BENCH_FRAMES            4     // Frames run per scenario
+
+// Scenarios. name, player x, y (level coords) and heading (1/256 turns),
+// then up to 3 entities as type, x, y (type 0 for none). The entities of
+// the map around are spawned by spawnEntities() as usual
+#define BENCH_SCENARIOS(S) \
+  S(spawn,      29, 10,   0,   0,  0,  0,   0,  0,  0,   0,  0,  0)   /* start room, door ahead */ \
+  S(wall,       29, 10, 128,   0,  0,  0,   0,  0,  0,   0,  0,  0)   /* a wall filling the view */ \
+  S(corridor,   34, 14,  64,   2, 34, 21,   0,  0,  0,   0,  0,  0)   /* long corridor, enemy far away */ \
+  S(hall,       28, 29,   0,   2, 30, 30,   2, 38, 30,   8, 31, 29)   /* open room, deep view */ \
+  S(close,      52, 17,   0,   2, 55, 17,   9, 58, 17,   0,  0,  0)   /* enemy and key up close */
+
+#endif
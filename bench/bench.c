@@ -0,0 +1,230 @@
+/*
+  Cycle counts of the render and update stages, on the AVR firmware built
+  with BENCHMARK (see ../bench.h), run under simavr.
+
+  bench [-b baseline] [-t percent] [-u] firmware.elf
+    -b  Baseline file, "<scenario> <stage> <cycles>" per line
+    -t  Regression threshold in percent. Defaults to 2
+    -u  Write the counts to the baseline instead of comparing
+
+  Counts are the cycles of all the BENCH_FRAMES frames of each scenario.
+  The exit status is 1 when a stage is slower than its baseline by more
+  than the threshold. A stage missing in the baseline isn't compared.
+
+  simavr runs the TWI at its real speed, and ACKs the display here, so
+  display() includes the time on the bus.
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/avr_twi.h>
+
+#include "../bench.h"
+
+#define MCU                 "atmega328p"
+#define FREQUENCY           16000000
+
+// Data space addresses of the marker registers
+#define GPIOR0_ADDR         0x3E
+#define GPIOR1_ADDR         0x4A
+#define GPIOR2_ADDR         0x4B
+
+#define MAX_CYCLES          (60ULL * FREQUENCY)   // Give up after a minute of AVR time
+
+#define BENCH_NAME(name, ...) #name,
+static const char *scenario_names[] = { BENCH_SCENARIOS(BENCH_NAME) };
+#define SCENARIOS           (sizeof(scenario_names) / sizeof(scenario_names[0]))
+
+static const char *stage_names[BENCH_STAGES] = {
+  "updateEntities", "renderMap", "renderEntities", "drawDisplayList", "renderGun", "display",
+  "getBlockAt", "isWall", "getDistanceAt"
+};
+
+static uint64_t cycles[SCENARIOS][BENCH_STAGES];
+static uint64_t stage_start[BENCH_STAGES];
+static int scenario = -1;
+static int done = 0;
+
+// Markers
+static void onStage(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+  avr->data[addr] = v;
+  uint8_t stage = v & ~BENCH_BEGIN;
+
+  if (stage >= BENCH_STAGES || scenario < 0) {
+    fprintf(stderr, "bench: unexpected marker 0x%02x\n", v);
+    exit(2);
+  }
+  if (v & BENCH_BEGIN) {
+    stage_start[stage] = avr->cycle;
+  } else {
+    cycles[scenario][stage] += avr->cycle - stage_start[stage];
+  }
+}
+
+static void onScenario(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+  avr->data[addr] = v;
+  if (v >= SCENARIOS) {
+    fprintf(stderr, "bench: unknown scenario %u\n", v);
+    exit(2);
+  }
+  scenario = v;
+}
+
+static void onDone(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+  avr->data[addr] = v;
+  if (v == BENCH_DONE) done = 1;
+}
+
+// The display. ACKs everything sent to it
+static avr_irq_t *twi_irq;
+
+static void onTwi(avr_irq_t *irq, uint32_t value, void *param) {
+  avr_twi_msg_irq_t msg;
+  msg.u.v = value;
+
+  if (msg.u.twi.msg & (TWI_COND_START | TWI_COND_WRITE)) {
+    avr_raise_irq(twi_irq + 1, avr_twi_irq_msg(TWI_COND_ACK, msg.u.twi.addr, 1));
+  }
+}
+
+static void attachDisplay(avr_t *avr) {
+  static const char *names[] = { "twi.out", "twi.in" };
+  twi_irq = avr_alloc_irq(&avr->irq_pool, 0, 2, names);
+
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), twi_irq);
+  avr_connect_irq(twi_irq + 1, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+  avr_irq_register_notify(twi_irq, onTwi, NULL);
+}
+
+// Baseline
+static uint64_t baseline[SCENARIOS][BENCH_STAGES];
+
+static int findName(const char **names, unsigned count, const char *name) {
+  for (unsigned i = 0; i < count; i++) {
+    if (!strcmp(names[i], name)) return i;
+  }
+  return -1;
+}
+
+static int readBaseline(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) return 0;
+
+  char line[128], scenario_name[64], stage_name[64];
+  unsigned long long count;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "%63s %63s %llu", scenario_name, stage_name, &count) != 3) continue;
+
+    int s = findName(scenario_names, SCENARIOS, scenario_name);
+    int t = findName(stage_names, BENCH_STAGES, stage_name);
+    if (s >= 0 && t >= 0) baseline[s][t] = count;
+  }
+  fclose(f);
+  return 1;
+}
+
+static void writeBaseline(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    perror(path);
+    exit(2);
+  }
+
+  for (unsigned s = 0; s < SCENARIOS; s++) {
+    for (unsigned t = 0; t < BENCH_STAGES; t++) {
+      if (cycles[s][t]) fprintf(f, "%s %s %llu\n", scenario_names[s], stage_names[t], (unsigned long long) cycles[s][t]);
+    }
+  }
+  fclose(f);
+}
+
+int main(int argc, char **argv) {
+  const char *baseline_path = "baseline.txt";
+  double threshold = 2;
+  int update = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:t:u")) != -1) {
+    switch (opt) {
+      case 'b': baseline_path = optarg; break;
+      case 't': threshold = atof(optarg); break;
+      case 'u': update = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-b baseline] [-t percent] [-u] firmware.elf\n", argv[0]);
+        return 2;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-b baseline] [-t percent] [-u] firmware.elf\n", argv[0]);
+    return 2;
+  }
+
+  elf_firmware_t firmware = {0};
+  if (elf_read_firmware(argv[optind], &firmware)) {
+    fprintf(stderr, "bench: can't load %s\n", argv[optind]);
+    return 2;
+  }
+
+  avr_t *avr = avr_make_mcu_by_name(MCU);
+  if (!avr) {
+    fprintf(stderr, "bench: simavr doesn't support %s\n", MCU);
+    return 2;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = FREQUENCY;
+
+  avr_register_io_write(avr, GPIOR0_ADDR, onStage, NULL);
+  avr_register_io_write(avr, GPIOR1_ADDR, onScenario, NULL);
+  avr_register_io_write(avr, GPIOR2_ADDR, onDone, NULL);
+  attachDisplay(avr);
+
+  int state = cpu_Running;
+  while (!done && state != cpu_Done && state != cpu_Crashed && avr->cycle < MAX_CYCLES) {
+    state = avr_run(avr);
+  }
+  if (!done) {
+    fprintf(stderr, "bench: the firmware stopped before the end (scenario %d, cycle %llu)\n",
+      scenario, (unsigned long long) avr->cycle);
+    return 2;
+  }
+
+  if (update) {
+    writeBaseline(baseline_path);
+    printf("Baseline written to %s\n", baseline_path);
+  }
+  int compare = !update && readBaseline(baseline_path);
+
+  // Report
+  int regressions = 0;
+  printf("%-10s %-16s %12s %12s %8s\n", "scenario", "stage", "cycles", "baseline", "change");
+  for (unsigned s = 0; s < SCENARIOS; s++) {
+    for (unsigned t = 0; t < BENCH_STAGES; t++) {
+      uint64_t count = cycles[s][t];
+      uint64_t base = compare ? baseline[s][t] : 0;
+      if (!count && !base) continue;
+
+      printf("%-10s %-16s %12llu", scenario_names[s], stage_names[t], (unsigned long long) count);
+      if (base) {
+        double change = 100.0 * ((double) count - base) / base;
+        int regressed = change > threshold;
+        regressions += regressed;
+        printf(" %12llu %+7.2f%%%s\n", (unsigned long long) base, change, regressed ? "  REGRESSION" : "");
+      } else {
+        printf("\n");
+      }
+    }
+  }
+
+  if (regressions) {
+    printf("%d stage(s) regressed by more than %.1f%%\n", regressions, threshold);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,150 @@
+#ifndef _camera_h
+#define _camera_h
+
+#include "hal.h"
+#include "constants.h"
+#include "fixed.h"
+
+/*
+  Generated by tools/gen_camera.py. Do not edit.
+
+  The player heading is a quantized angle (1/256 turns). The camera uses
+  CAMERA_HEADINGS steps of it, so each one has precomputed ray reciprocals.
+
+  For a heading a in the first quadrant and camera column k (camera_x = 2k / COLUMNS - 1):
+    ray_x(a, k) = cos(a) + PLANE * camera_x * sin(a)
+    ray_y(a, k) = ray_x(QUARTER - a, COLUMNS - k)
+  Other quadrants rotate those by 90 degrees.
+*/
+#define CAMERA_HEADINGS     64
+#define CAMERA_QUARTER      16
+#define CAMERA_COLUMNS      64          // SCREEN_WIDTH / RES_DIVIDER
+#define CAMERA_ANGLE_SHIFT  2           // 256 angle units / CAMERA_HEADINGS
+#define CAMERA_PLANE        0.66        // Camera plane length (field of view)
+#define CAMERA_PLANE_DIR    2703        // The same, Q4.12
+
+static_assert(CAMERA_COLUMNS == SCREEN_WIDTH / RES_DIVIDER, "camera.h is stale: python3 tools/gen_camera.py < constants.h > camera.h");
+
+// sin() of the first quadrant headings, Q4.12
+const static int16_t PROGMEM camera_sin[CAMERA_QUARTER + 1] = {
+  0, 401, 799, 1189, 1567, 1931, 2276, 2598, 2896, 3166, 3406, 3612, 3784, 3920, 4017, 4076,
+  4096,
+};
+
+// 1 / ray_x of the first quadrant headings, Q8.8 signed, saturated to 0x7FFF
+const static int16_t PROGMEM camera_ray_recip[(CAMERA_QUARTER + 1) * (CAMERA_COLUMNS + 1)] = {
+  256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  275, 275, 274, 273, 273, 272, 272, 271, 270, 270, 269, 269, 268,
+  268, 267, 266, 266, 265, 265, 264, 264, 263, 263, 262, 261, 261,
+  260, 260, 259, 259, 258, 258, 257, 257, 256, 256, 255, 255, 254,
+  254, 253, 253, 252, 252, 251, 251, 250, 250, 249, 249, 248, 248,
+  247, 247, 246, 246, 245, 245, 244, 244, 243, 243, 242, 242, 242,
+  300, 299, 298, 296, 295, 294, 292, 291, 290, 288, 287, 286, 284,
+  283, 282, 281, 279, 278, 277, 276, 275, 273, 272, 271, 270, 269,
+  268, 266, 265, 264, 263, 262, 261, 260, 259, 258, 257, 256, 255,
+  254, 253, 252, 251, 250, 249, 248, 247, 246, 245, 244, 243, 242,
+  241, 240, 239, 239, 238, 237, 236, 235, 234, 233, 232, 232, 231,
+  334, 332, 329, 327, 324, 322, 319, 317, 315, 312, 310, 308, 306,
+  304, 301, 299, 297, 295, 293, 291, 289, 287, 285, 283, 282, 280,
+  278, 276, 274, 273, 271, 269, 268, 266, 264, 263, 261, 259, 258,
+  256, 255, 253, 252, 250, 249, 247, 246, 245, 243, 242, 240, 239,
+  238, 236, 235, 234, 233, 231, 230, 229, 228, 226, 225, 224, 223,
+  381, 377, 373, 368, 364, 360, 356, 352, 349, 345, 341, 338, 334,
+  331, 327, 324, 321, 318, 315, 312, 309, 306, 303, 300, 297, 295,
+  292, 289, 287, 284, 282, 279, 277, 275, 272, 270, 268, 266, 264,
+  261, 259, 257, 255, 253, 251, 249, 247, 246, 244, 242, 240, 238,
+  237, 235, 233, 232, 230, 228, 227, 225, 224, 222, 221, 219, 218,
+  448, 441, 434, 427, 420, 413, 407, 401, 395, 389, 383, 378, 372,
+  367, 362, 357, 352, 348, 343, 339, 335, 330, 326, 322, 318, 315,
+  311, 307, 304, 300, 297, 294, 290, 287, 284, 281, 278, 275, 272,
+  269, 267, 264, 261, 259, 256, 254, 251, 249, 247, 244, 242, 240,
+  238, 236, 234, 232, 230, 228, 226, 224, 222, 220, 218, 216, 215,
+  551, 538, 525, 513, 501, 490, 480, 470, 460, 451, 442, 433, 425,
+  417, 409, 402, 395, 388, 381, 375, 369, 363, 357, 351, 346, 341,
+  336, 331, 326, 321, 317, 312, 308, 304, 300, 296, 292, 288, 284,
+  281, 277, 274, 271, 267, 264, 261, 258, 255, 252, 249, 247, 244,
+  241, 239, 236, 234, 231, 229, 227, 224, 222, 220, 218, 216, 214,
+  723, 697, 673, 650, 630, 610, 591, 574, 558, 542, 528, 514, 501,
+  488, 476, 465, 454, 444, 434, 425, 416, 407, 399, 391, 383, 376,
+  369, 362, 355, 349, 343, 337, 331, 326, 320, 315, 310, 305, 301,
+  296, 292, 287, 283, 279, 275, 271, 268, 264, 261, 257, 254, 251,
+  247, 244, 241, 238, 236, 233, 230, 227, 225, 222, 220, 217, 215,
+  1065, 1004, 950, 901, 857, 817, 781, 747, 717, 689, 663, 639, 616,
+  595, 576, 558, 540, 524, 509, 495, 481, 468, 456, 445, 434, 423,
+  413, 404, 395, 386, 378, 370, 362, 355, 348, 341, 334, 328, 322,
+  316, 311, 305, 300, 295, 290, 285, 281, 276, 272, 268, 264, 260,
+  256, 253, 249, 246, 242, 239, 236, 233, 230, 227, 224, 221, 218,
+  2061, 1827, 1640, 1488, 1362, 1255, 1164, 1086, 1017, 956, 903, 855, 811,
+  772, 737, 705, 675, 648, 623, 599, 578, 558, 539, 521, 505, 490,
+  475, 462, 449, 436, 425, 414, 404, 394, 384, 375, 367, 358, 351,
+  343, 336, 329, 322, 316, 310, 304, 299, 293, 288, 283, 278, 273,
+  269, 264, 260, 256, 252, 248, 244, 240, 237, 233, 230, 227, 224,
+  32767, 10689, 6229, 4395, 3395, 2766, 2334, 2018, 1778, 1589, 1436, 1310, 1204,
+  1114, 1037, 970, 910, 858, 811, 770, 732, 698, 667, 638, 612, 588,
+  566, 545, 526, 508, 491, 475, 461, 447, 434, 422, 410, 399, 389,
+  379, 370, 361, 352, 344, 336, 329, 322, 315, 308, 302, 296, 290,
+  285, 280, 274, 269, 265, 260, 256, 251, 247, 243, 239, 235, 232,
+  -2313, -2768, -3446, -4563, -6752, -12980, -32767, 15370, 7347, 4827, 3594, 2863, 2379,
+  2035, 1778, 1579, 1419, 1289, 1181, 1090, 1011, 944, 884, 832, 786, 744,
+  707, 673, 642, 614, 588, 565, 543, 523, 504, 487, 470, 455, 441,
+  428, 415, 403, 392, 381, 371, 362, 353, 344, 336, 328, 320, 313,
+  307, 300, 294, 288, 282, 276, 271, 266, 261, 256, 252, 247, 243,
+  -1127, -1231, -1355, -1507, -1697, -1942, -2271, -2732, -3430, -4606, -7009, -14652, 32767,
+  12404, 6449, 4358, 3290, 2643, 2209, 1897, 1662, 1479, 1332, 1212, 1112, 1027,
+  954, 891, 835, 786, 743, 704, 669, 637, 608, 582, 558, 536, 515,
+  496, 478, 462, 447, 432, 419, 406, 394, 383, 372, 362, 353, 344,
+  335, 327, 319, 312, 305, 298, 292, 285, 279, 274, 268, 263, 258,
+  -750, -796, -848, -908, -976, -1055, -1149, -1260, -1396, -1564, -1779, -2061, -2451,
+  -3022, -3940, -5658, -10037, -32767, 18327, 7595, 4790, 3498, 2755, 2272, 1934, 1683,
+  1490, 1336, 1211, 1108, 1021, 946, 882, 826, 776, 732, 693, 658, 626,
+  598, 571, 547, 525, 505, 486, 468, 452, 437, 422, 409, 397, 385,
+  374, 363, 353, 344, 335, 327, 319, 311, 304, 297, 290, 284, 278,
+  -566, -593, -622, -654, -689, -729, -774, -824, -882, -948, -1024, -1114, -1222,
+  -1353, -1515, -1720, -1991, -2363, -2905, -3771, -5372, -9334, -32767, 19644, 7697, 4786,
+  3473, 2725, 2242, 1905, 1656, 1464, 1312, 1189, 1087, 1001, 928, 864, 809,
+  760, 717, 679, 644, 613, 585, 559, 535, 514, 493, 475, 458, 442,
+  427, 413, 400, 388, 376, 365, 355, 345, 336, 327, 319, 311, 304,
+  -458, -476, -494, -515, -537, -561, -588, -617, -649, -684, -724, -769, -819,
+  -877, -943, -1020, -1111, -1220, -1352, -1516, -1726, -2004, -2387, -2952, -3868, -5606,
+  -10184, -32767, 16086, 7025, 4494, 3304, 2612, 2160, 1841, 1604, 1421, 1276, 1157,
+  1059, 976, 905, 844, 791, 743, 702, 664, 631, 600, 573, 548, 525,
+  503, 484, 466, 449, 433, 419, 405, 393, 381, 369, 359, 349, 339,
+  -388, -400, -414, -428, -443, -460, -477, -496, -517, -540, -564, -591, -621,
+  -653, -690, -730, -776, -827, -887, -955, -1034, -1128, -1241, -1379, -1552, -1773,
+  -2069, -2482, -3103, -4137, -6206, -12412, 32767, 12412, 6206, 4137, 3103, 2482, 2069,
+  1773, 1552, 1379, 1241, 1128, 1034, 955, 887, 827, 776, 730, 690, 653,
+  621, 591, 564, 540, 517, 496, 477, 460, 443, 428, 414, 400, 388,
+};
+
+// sin() of a heading (0..CAMERA_HEADINGS - 1), Q4.12
+inline int16_t camera_heading_sin(uint8_t heading) {
+  uint8_t a = heading & (CAMERA_QUARTER - 1);
+  uint8_t quad = (heading / CAMERA_QUARTER) & 0b11;
+  int16_t s = pgm_read_word(camera_sin + (quad & 1 ? CAMERA_QUARTER - a : a));
+  return quad & 0b10 ? -s : s;
+}
+
+inline int16_t camera_heading_cos(uint8_t heading) {
+  return camera_heading_sin(heading + CAMERA_QUARTER);
+}
+
+// 1 / ray of the camera column k (0..CAMERA_COLUMNS) for a heading, Q8.8 signed
+inline void camera_ray_recip_at(uint8_t heading, uint8_t k, int16_t *recip_x, int16_t *recip_y) {
+  uint8_t a = heading & (CAMERA_QUARTER - 1);
+  int16_t x = pgm_read_word(camera_ray_recip + a * (CAMERA_COLUMNS + 1) + k);
+  int16_t y = pgm_read_word(camera_ray_recip + (CAMERA_QUARTER - a) * (CAMERA_COLUMNS + 1) + CAMERA_COLUMNS - k);
+
+  // rotate by 90 degrees steps
+  switch ((heading / CAMERA_QUARTER) & 0b11) {
+    case 0: *recip_x = x;  *recip_y = y;  break;
+    case 1: *recip_x = -y; *recip_y = x;  break;
+    case 2: *recip_x = -x; *recip_y = -y; break;
+    case 3: *recip_x = y;  *recip_y = -x; break;
+  }
+}
+
+#endif
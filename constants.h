@@ -7,7 +7,7 @@
 #define K_RIGHT             7
 #define K_UP                8
 #define K_DOWN              3
-#define K_FIRE              10
+#define K_FIRE              10          // Moves to 2 with SSD1306_SPI (10 is the SPI chip select)
 
 // SNES Controller
 // uncomment following line to enable snes controller support
@@ -21,17 +21,41 @@ constexpr uint8_t SOUND_PIN   = 9; // do not change, belongs to used timer
 
 // GFX settings
 #define OPTIMIZE_SSD1306                // Optimizations for SSD1366 displays
+// #define SSD1306_SPI                  // Display on hardware SPI (8MHz) instead of I2C (400KHz). Pins in SPI_Master.h
+// #define SSD1306_DELTA_FLUSH          // Only send the display segments changed since last frame. Uses 64 bytes of RAM
+// #define SSD1306_BAND_PAGES  1       // Render the screen in bands of this many pages (8 rows) instead of keeping
+                                        // the 1KB frame buffer. Frees ~590 bytes of RAM (with 1 page), costs CPU
+#define FIXED_POINT_RAYCASTER           // Integer (Q8.8) raycaster. Comment to use the double version.
+                                        // Wall heights match within 1px and zbuffer within 1 unit, except for
+                                        // rays grazing a corner (<0.5% of columns)
+
+#ifdef SSD1306_SPI
+#ifdef SNES_CONTROLLER
+#error "The SNES controller pins are used by SPI"
+#endif
+#undef K_FIRE
+#define K_FIRE              2
+#endif
+
+// Debug
+// #define PROFILER            PROFILE_SERIAL  // Time the stages of the game loop (profile.h). PROFILE_SERIAL (115200 baud)
+                                            // or PROFILE_HUD. Uses ~75 bytes of RAM
+// #define INPUT_RECORD        RECORD_EEPROM   // Record the input of each game (record.h). RECORD_EEPROM or RECORD_SERIAL
+// #define INPUT_REPLAY        RECORD_EEPROM   // Play a recording back, instead of the buttons, and report its time
 
-#define FRAME_TIME          66.666666   // Desired time per frame in ms (66.666666 is ~15 fps)
+#define STEP_TICKS          65          // Simulation step, in scheduler ticks of 1.024ms (65 is ~15 steps per second)
+#define MAX_STEPS           4           // Steps simulated at most per frame. Slower frames slow the game down
+// #define QUALITY_GOVERNOR    15          // Target fps. Lowers the render quality at runtime while the frames miss it (quality.h).
+                                            // The stock build runs ~14 fps, so a target above that always trades quality for speed
 #define RES_DIVIDER         2           // Higher values will result in lower horizontal resolution when rasterize and lower process and memory usage
-                                        // Lower will require more process and memory, but looks nicer
+                                        // Lower will require more process and memory, but looks nicer. Regenerate camera.h after changing it
 #define Z_RES_DIVIDER       2           // Zbuffer resolution divider. We sacrifice resolution to save memory
+#define ZBUFFER_DEPTH       ZDepth8     // Zbuffer depth encoding: ZDepth8, ZDepth12 (more precise, 1.5x memory) or ZDepthLog
 #define DISTANCE_MULTIPLIER 20          // Distances are stored as uint8_t, multiplying the distance we can obtain more precision taking care
                                         // of keep numbers inside the type range. Max is 256 / MAX_RENDER_DEPTH
 #define MAX_RENDER_DEPTH    12
 #define MAX_SPRITE_DEPTH    8
 
-#define ZBUFFER_SIZE        SCREEN_WIDTH / Z_RES_DIVIDER
 
 // Level 
 #define LEVEL_WIDTH_BASE    6
@@ -47,7 +71,7 @@ constexpr uint8_t SOUND_PIN   = 9; // do not change, belongs to used timer
 #define GUN_TARGET_POS        18
 #define GUN_SHOT_POS          GUN_TARGET_POS + 4
 
-#define ROT_SPEED             .12
+#define ROT_SPEED             4           // Angle units (1/256 turn) per frame. ~.1 rad
 #define MOV_SPEED             .2
 #define MOV_SPEED_INV         5           // 1 / MOV_SPEED
 
@@ -56,10 +80,12 @@ constexpr uint8_t SOUND_PIN   = 9; // do not change, belongs to used timer
 #define FIREBALL_SPEED        .2
 #define FIREBALL_ANGLES       45          // Num of angles per PI
 
-#define MAX_ENTITIES          10          // Max num of active entities
-#define MAX_STATIC_ENTITIES   28          // Max num of entities in sleep mode
+#define MAX_ENTITIES          12          // Max num of active entities. Up to 16 (pool.h)
+#define MAX_SAVED_ENEMIES     4           // Enemies dozed alive that come back where they were (world.h). 0 for none
 
 #define MAX_ENTITY_DISTANCE   200         // * DISTANCE_MULTIPLIER
+#define SPAWN_DISTANCE        8           // Cells. The level entities closer are spawned. Under MAX_ENTITY_DISTANCE, so they don't come and go
+#define SPAWN_FRAMES          4           // Frames between the spawn passes
 #define MAX_ENEMY_VIEW        80          // * DISTANCE_MULTIPLIER
 #define ITEM_COLLIDER_DIST    6           // * DISTANCE_MULTIPLIER
 #define ENEMY_COLLIDER_DIST   4           // * DISTANCE_MULTIPLIER
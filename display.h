@@ -3,6 +3,8 @@ todo: Moving this to CPP looks like it takes more Flash storage. Figure out why.
 */
 #include "SSD1306.h"
 #include "constants.h"
+#include "zbuffer.h"
+#include "quality.h"
 
 // Reads a char from an F() string
 #define F_char(ifsh, ch)    pgm_read_byte(reinterpret_cast<PGM_P>(ifsh) + ch)
@@ -12,14 +14,20 @@ const static uint8_t PROGMEM bit_mask[8] = { 128, 64, 32, 16, 8, 4, 2, 1 };
 #define read_bit(b, n)      b & pgm_read_byte(bit_mask + n) ? 1 : 0
 
 void setupDisplay();
-void fps();
+void firstBand();
+bool nextBand();
 bool getGradientPixel(uint8_t x, uint8_t y, uint8_t i);
+uint8_t getGradientByte(uint8_t x, uint8_t i);
 void fadeScreen(uint8_t intensity, bool color);
 void drawByte(uint8_t x, uint8_t y, uint8_t b);
 uint8_t getByte(uint8_t x, uint8_t y);
 void drawPixel(int8_t x, int8_t y, bool color, bool raycasterViewport);
 void drawVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity);
-void drawSprite(int8_t x, int8_t y, const uint8_t bitmap[], const uint8_t mask[], int16_t w, int16_t h, uint8_t sprite, double distance);
+void drawSprite(int16_t x, int8_t y, const SpriteMip mips[], uint8_t levels, uint8_t sprite, double distance);
+void renderVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity);
+void renderSprite(int16_t x, int8_t y, const SpriteMip mips[], uint8_t levels, uint8_t sprite, double distance);
+void clearDisplayList();
+void drawDisplayList();
 void drawChar(int8_t x, int8_t y, char ch);
 void drawText(int8_t x, int8_t y, char *txt, uint8_t space = 1);
 void drawText(int8_t x, int8_t y, const __FlashStringHelper txt, uint8_t space = 1);
@@ -27,18 +35,47 @@ void drawText(int8_t x, int8_t y, const __FlashStringHelper txt, uint8_t space =
 // Initialize screen. Following line is for OLED 128x64 connected by I2C
 Adafruit_SSD1306<SCREEN_WIDTH, SCREEN_HEIGHT> display;
 
-// FPS control
-double delta = 1;
-uint32_t lastFrameTime = 0;
-
 #ifdef OPTIMIZE_SSD1306
 // Optimizations for SSD1306 handles buffer directly
+// In band mode it points where page 0 would be, so it's still indexed with
+// screen coordinates (only the rows of the current band are valid)
 uint8_t *display_buf;
 #endif
 
+#ifdef SSD1306_BAND_PAGES
+// Rows of the screen held by the buffer: the current band
+uint8_t band_top = 0;
+#define BAND_TOP            band_top
+#define BAND_BOTTOM         (band_top + SSD1306_BAND_PAGES * 8)
+
+// Display list. Walls and sprites are computed once per frame and drawn
+// again for every band
+struct WallColumn {
+  int8_t start_y;
+  int8_t end_y;
+  uint8_t intensity;
+};
+
+struct SpriteCall {
+  int16_t x;
+  int8_t y;
+  const SpriteMip *mips;
+  uint8_t levels;
+  uint8_t sprite;
+  double distance;
+};
+
+WallColumn wall_columns[SCREEN_WIDTH / RES_DIVIDER];
+SpriteCall sprite_calls[MAX_ENTITIES];
+uint8_t num_sprite_calls = 0;
+#else
+#define BAND_TOP            0
+#define BAND_BOTTOM         SCREEN_HEIGHT
+#endif
+
 // We don't handle more than MAX_RENDER_DEPTH depth, so we can safety store
-// z values in a byte with 1 decimal and save some memory,
-uint8_t zbuffer[ZBUFFER_SIZE];
+// z values in a few bits and save some memory. See zbuffer.h
+ZBuffer<Z_RES_DIVIDER, ZBUFFER_DEPTH> zbuffer;
 
 void setupDisplay() {
   // Setup display
@@ -53,19 +90,41 @@ void setupDisplay() {
 #endif
 
   // initialize z buffer
-  memset(zbuffer, 0xFF, ZBUFFER_SIZE);
+  zbuffer.clear();
+}
+
+#ifdef SSD1306_BAND_PAGES
+void setBand() {
+  band_top = display.getPage() * 8;
+#ifdef OPTIMIZE_SSD1306
+  display_buf = display.getBuffer() - display.getPage() * SCREEN_WIDTH;
+#endif
 }
+#endif
 
-// Adds a delay to limit play to specified fps
-// Calculates also delta to keep movement consistent in lower framerates
-void fps() {
-  while (millis() - lastFrameTime < FRAME_TIME);
-  delta = (double)(millis() - lastFrameTime) / FRAME_TIME;
-  lastFrameTime = millis();
+// Draw a frame with:
+//   firstBand();
+//   do { ...draw... } while (nextBand());
+// In band mode the loop runs once per band, and drawing is clipped to it.
+// Otherwise it runs once and the buffer isn't cleared.
+void firstBand() {
+#ifdef SSD1306_BAND_PAGES
+  display.firstPage();
+  setBand();
+#else
+  display.waitDisplay();
+#endif
 }
 
-double getActualFps() {
-  return 1000 / (FRAME_TIME * delta);
+bool nextBand() {
+#ifdef SSD1306_BAND_PAGES
+  bool more = display.nextPage();
+  setBand();
+  return more;
+#else
+  display.display();
+  return false;
+#endif
 }
 
 // Faster way to render vertical bits
@@ -87,20 +146,40 @@ boolean getGradientPixel(uint8_t x, uint8_t y, uint8_t i) {
   return read_bit(pgm_read_byte(gradient + index), x % 8);
 }
 
+// Vertical byte of the gradient for a column. Same for all the pages
+uint8_t getGradientByte(uint8_t x, uint8_t i) {
+  if (i >= GRADIENT_COUNT - 1) return 0xFF;
+
+  return pgm_read_byte(gradient_columns + i * GRADIENT_COLUMNS + x % GRADIENT_COLUMNS);
+}
+
 void fadeScreen(uint8_t intensity, bool color = 0) {
+#ifdef OPTIMIZE_SSD1306
+  for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
+    uint8_t b = getGradientByte(x, intensity);
+    for (uint8_t p = BAND_TOP / 8; p < BAND_BOTTOM / 8; p++) {
+      if (color) {
+        display_buf[p * SCREEN_WIDTH + x] |= b;
+      } else {
+        display_buf[p * SCREEN_WIDTH + x] &= ~b;
+      }
+    }
+  }
+#else
   for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
     for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
       if (getGradientPixel(x, y, intensity)) 
         drawPixel(x, y, color, false);
     }
   }
+#endif
 }
 
 // Faster drawPixel than display.drawPixel.
 // Avoids some checks to make it faster.
 void drawPixel(int8_t x, int8_t y, bool color, bool raycasterViewport = false) {
   // prevent write out of screen buffer
-  if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= (raycasterViewport ? RENDER_HEIGHT : SCREEN_HEIGHT)) {
+  if (x < 0 || x >= SCREEN_WIDTH || y < BAND_TOP || y >= BAND_BOTTOM || y >= (raycasterViewport ? RENDER_HEIGHT : SCREEN_HEIGHT)) {
     return;
   }
 
@@ -119,41 +198,38 @@ void drawPixel(int8_t x, int8_t y, bool color, bool raycasterViewport = false) {
 
 // For raycaster only
 // Custom draw Vertical lines that fills with a pattern to simulate
-// different brightness. Affected by RES_DIVIDER
+// different brightness. Affected by res_divider
 void drawVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity) {
-  int8_t y;
-  int8_t lower_y = max(min(start_y, end_y), 0);
-  int8_t higher_y = min(max(start_y, end_y), RENDER_HEIGHT - 1);
+  int8_t lower_y = max(min(start_y, end_y), BAND_TOP);
+  int8_t higher_y = min(max(start_y, end_y), min(RENDER_HEIGHT, BAND_BOTTOM) - 1);
   uint8_t c;
 
-#ifdef OPTIMIZE_SSD1306
-  uint8_t bp;
-  uint8_t b;
-  for (c = 0; c < RES_DIVIDER; c++) {
-    y = lower_y;
-    b = 0;
-    while (y <= higher_y) {
-      bp = y % 8;
-      b = b | getGradientPixel(x + c, y, intensity) << bp;
-
-      if (bp == 7) {
-        // write the whole byte
-        drawByte(x + c, y, b);
-        b = 0;
-      }
-
-      y++;
-    }
+  if (higher_y < lower_y) return;
 
-    // draw last byte
-    if (bp != 7) {
-      drawByte(x + c, y - 1, b);
+#ifdef OPTIMIZE_SSD1306
+  // Writes whole page bytes: the dither byte of the column masked by the span.
+  // At most RENDER_HEIGHT / 8 writes per column
+  uint8_t top_page = lower_y / 8;
+  uint8_t bottom_page = higher_y / 8;
+  uint8_t top_mask = 0xFF << (lower_y & 7);
+  uint8_t bottom_mask = 0xFF >> (7 - (higher_y & 7));
+
+  for (c = 0; c < res_divider; c++) {
+    uint8_t pattern = getGradientByte(x + c, intensity);
+    uint8_t *b = display_buf + top_page * SCREEN_WIDTH + x + c;
+    uint8_t mask = top_mask;
+
+    for (uint8_t p = top_page; p <= bottom_page; p++) {
+      if (p == bottom_page) mask &= bottom_mask;
+      *b = pattern & mask;
+      mask = 0xFF;
+      b += SCREEN_WIDTH;
     }
   }
 #else
-  y = lower_y;
+  int8_t y = lower_y;
   while (y <= higher_y) {
-    for (c = 0; c < RES_DIVIDER; c++) {
+    for (c = 0; c < res_divider; c++) {
       // bypass black pixels
       if (getGradientPixel(x + c, y, intensity)) {
         drawPixel(x + c, y, 1, true);
@@ -165,60 +241,158 @@ void drawVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity) {
 #endif
 }
 
-// Custom drawBitmap method with scale support, mask, zindex and pattern filling
+// Custom drawBitmap method with scale support, mask, zindex and pattern filling.
+// Walks the screen columns with integer steps over the sprite. Each column is
+// tested against the z buffer as a whole, and its pixels are composed into
+// page bytes before being written.
+// Far sprites are sampled from the smallest mip level covering their size.
+// At lower quality a sampled column is drawn sprite_step columns wide.
 void drawSprite(
-  int8_t x, int8_t y,
-  const uint8_t bitmap[], const uint8_t mask[],
-  int16_t w, int16_t h,
+  int16_t x, int8_t y,
+  const SpriteMip mips[], uint8_t levels,
   uint8_t sprite,
   double distance
 ) {
-  uint8_t tw = (double) w / distance;
-  uint8_t th = (double) h / distance;
+  SpriteMip mip;
+  memcpy_P(&mip, mips, sizeof(SpriteMip));
+
+  int16_t tw = (double) mip.width / distance;
+  int16_t th = (double) mip.height / distance;
+
+  for (uint8_t level = 1; level < levels; level++) {
+    SpriteMip next;
+    memcpy_P(&next, mips + level, sizeof(SpriteMip));
+    if (next.width < tw) break;
+    mip = next;
+  }
+
+  const uint8_t *bitmap = mip.bitmap;
+  const uint8_t *mask = mip.mask;
+  uint8_t w = mip.width;
+  uint8_t h = mip.height;
   uint8_t byte_width = w / 8;
-  uint8_t pixel_size = max(1, 1.0 / distance);
   uint16_t sprite_offset = byte_width * h * sprite;
+  uint16_t z = to_fixed(distance);
 
-  bool pixel;
-  bool maskPixel;
+  if (tw == 0 || th == 0) return;
 
-  // Don't draw the whole sprite if the anchor is hidden by z buffer
-  // Not checked per pixel for performance reasons
-  if (zbuffer[min(max(x, 0), ZBUFFER_SIZE - 1) / Z_RES_DIVIDER] < distance * DISTANCE_MULTIPLIER) {
-    return;
-  }
+  // Sprite pixels per screen pixel (Q8.8)
+  uint16_t u_step = ((uint16_t) w << 8) / tw;
+  uint16_t v_step = ((uint16_t) h << 8) / th;
+
+  // Clip to the raycaster viewport
+  int16_t x0 = max(x, 0);
+  int16_t x1 = min(x + tw, SCREEN_WIDTH);
+  int16_t y0 = max(y, BAND_TOP);
+  int16_t y1 = min(y + th, min(RENDER_HEIGHT, BAND_BOTTOM));
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint16_t u = (x0 - x) * u_step;
+  uint16_t v0 = (y0 - y) * v_step;
 
-  for (uint8_t ty = 0; ty < th; ty += pixel_size) {
-    // Don't draw out of screen
-    if (y + ty < 0 || y + ty >= RENDER_HEIGHT) {
+  for (int16_t sx = x0; sx < x1; sx += sprite_step, u += u_step * sprite_step) {
+    // Hidden by a wall. Discard the whole column
+    if (zbuffer.hides(sx, z)) {
       continue;
     }
 
-    uint8_t sy = ty * distance; // The y from the sprite
+    uint8_t cols = sprite_step == 1 ? 1 : min(sprite_step, x1 - sx);
 
-    for (uint8_t tx = 0; tx < tw; tx += pixel_size) {
-      uint8_t sx = tx * distance; // The x from the sprite
-      uint16_t byte_offset = sprite_offset + sy * byte_width + sx / 8;
+    uint8_t col = u >> 8;
+    uint8_t bit = pgm_read_byte(bit_mask + col % 8);
+    uint16_t col_offset = sprite_offset + col / 8;
+    uint16_t v = v0;
 
-      // Don't draw out of screen
-      if (x + tx < 0 || x + tx >= SCREEN_WIDTH) {
-        continue;
-      }
+#ifdef OPTIMIZE_SSD1306
+    uint8_t *b = display_buf + (y0 / 8) * SCREEN_WIDTH + sx;
+    uint8_t page_mask = 0;
+    uint8_t page_bits = 0;
+#endif
+
+    for (uint8_t sy = y0; sy < y1; sy++, v += v_step) {
+      uint16_t byte_offset = col_offset + (v >> 8) * byte_width;
 
-      maskPixel = read_bit(pgm_read_byte(mask + byte_offset), sx % 8);
+      if (pgm_read_byte(mask + byte_offset) & bit) {
+        bool pixel = pgm_read_byte(bitmap + byte_offset) & bit;
+#ifdef OPTIMIZE_SSD1306
+        uint8_t m = 1 << (sy % 8);
+        page_mask |= m;
+        if (pixel) page_bits |= m;
+#else
+        for (uint8_t c = 0; c < cols; c++) {
+          drawPixel(sx + c, sy, pixel, true);
+        }
+#endif
+      }
 
-      if (maskPixel) {
-        pixel = read_bit(pgm_read_byte(bitmap + byte_offset), sx % 8);
-        for (uint8_t ox = 0; ox < pixel_size; ox++) {
-          for (uint8_t oy = 0; oy < pixel_size; oy++) {
-            drawPixel(x + tx + ox, y + ty + oy, pixel, true);
+#ifdef OPTIMIZE_SSD1306
+      // Flush the page byte
+      if (sy % 8 == 7 || sy == y1 - 1) {
+        if (page_mask) {
+          for (uint8_t c = 0; c < cols; c++) {
+            b[c] = (b[c] & ~page_mask) | page_bits;
           }
         }
+        page_mask = 0;
+        page_bits = 0;
+        b += SCREEN_WIDTH;
       }
+#endif
     }
   }
 }
 
+// Walls and sprites of the raycaster go through these. They are drawn right
+// away, or recorded in the display list in band mode.
+void renderVLine(uint8_t x, int8_t start_y, int8_t end_y, uint8_t intensity) {
+#ifdef SSD1306_BAND_PAGES
+  wall_columns[x / RES_DIVIDER] = { start_y, end_y, intensity };
+#else
+  drawVLine(x, start_y, end_y, intensity);
+#endif
+}
+
+void renderSprite(
+  int16_t x, int8_t y,
+  const SpriteMip mips[], uint8_t levels,
+  uint8_t sprite,
+  double distance
+) {
+#ifdef SSD1306_BAND_PAGES
+  if (num_sprite_calls < MAX_ENTITIES) {
+    sprite_calls[num_sprite_calls++] = { x, y, mips, levels, sprite, distance };
+  }
+#else
+  drawSprite(x, y, mips, levels, sprite, distance);
+#endif
+}
+
+void clearDisplayList() {
+#ifdef SSD1306_BAND_PAGES
+  // Columns without a wall are drawn as an empty span
+  for (uint8_t i = 0; i < SCREEN_WIDTH / RES_DIVIDER; i++) {
+    wall_columns[i] = { -1, -1, 0 };
+  }
+  num_sprite_calls = 0;
+#endif
+}
+
+// Draws the display list in the current band. With a coarser res_divider
+// the columns between the rays are left empty
+void drawDisplayList() {
+#ifdef SSD1306_BAND_PAGES
+  for (uint8_t i = 0; i < SCREEN_WIDTH / RES_DIVIDER; i++) {
+    WallColumn *c = &wall_columns[i];
+    drawVLine(i * RES_DIVIDER, c->start_y, c->end_y, c->intensity);
+  }
+
+  for (uint8_t i = 0; i < num_sprite_calls; i++) {
+    SpriteCall *s = &sprite_calls[i];
+    drawSprite(s->x, s->y, s->mips, s->levels, s->sprite, s->distance);
+  }
+#endif
+}
+
 // Draw a single character.
 // Made for a custom font with some useful sprites. Char size 4 x 6
 // Uses less memory than display.print()
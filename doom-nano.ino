@@ -1,15 +1,42 @@
+#include "hal.h"
 #include "constants.h"
+#include "fixed.h"
+#include "camera.h"
 #include "level.h"
+#include "level_distance.h"
+#include "level_walls.h"
+#include "level_entities.h"
+#include "world.h"
 #include "sprites.h"
+#include "sprite_mips.h"
 #include "input.h"
 #include "entities.h"
+#include "pool.h"
+#include "grid.h"
 #include "types.h"
 #include "display.h"
+#include "scheduler.h"
+#include "quality.h"
 #include "sound.h"
+#include "profile.h"
+#include "record.h"
+
+#ifdef BENCHMARK
+#include "bench.h"
+#define bench_begin(stage)    (GPIOR0 = BENCH_BEGIN | (stage))
+#define bench_end(stage)      (GPIOR0 = (stage))
+#endif
 
 // Useful macros
 #define swap(a, b)            do { typeof(a) temp = a; a = b; b = temp; } while (0)
-#define sign(a, b)            (double) (a > b ? 1 : (b > a ? -1 : 0))
+#define sign(a, b)            (int8_t) (a > b ? 1 : (b > a ? -1 : 0))
+
+// Used before they are defined. The Arduino IDE generates these, but the
+// host build (host/) doesn't
+uint8_t getBlockAt(const uint8_t level[], uint8_t x, uint8_t y);
+ViewCoords translateIntoView(Coords *pos);
+void rotatePlayer(int8_t amount);
+void updateHud();
 
 // general
 uint8_t scene = INTRO;
@@ -20,15 +47,20 @@ uint8_t flash_screen = 0;
 // game
 // player and entities
 Player player;
-Entity entity[MAX_ENTITIES];
-StaticEntity static_entity[MAX_STATIC_ENTITIES];
-uint8_t num_entities = 0;
-uint8_t num_static_entities = 0;
+uint8_t spawn_frames = 0;     // until the next spawn pass
+uint8_t entity_order[MAX_ENTITIES];   // slots in view in the last frame, far to close
+uint8_t num_ordered = 0;
 
 void setup(void) {
   setupDisplay();
   input_setup();
+  scheduler_init();
+  profile_setup();
+  record_setup();
+  #ifndef BENCHMARK
+  // The sound timer would add to the benchmark stages
   sound_init();
+  #endif
 }
 
 // Jump to another scene
@@ -37,14 +69,24 @@ void jumpTo(uint8_t target_scene) {
   exit_scene = true;
 }
 
-// Finds the player in the map
+// Finds the player in the map, and resets the game. Each game starts
+// the same, so the input recordings replay the same
 void initializeLevel(const uint8_t level[]) {
+  pool_reset();
+  world_reset();
+  flash_screen = 0;
+  invert_screen = false;
+  spawn_frames = 0;
+  gameTime = 0;
+  scheduler_reset();
+
   for (uint8_t y = LEVEL_HEIGHT - 1; y >= 0; y--) {
     for (uint8_t x = 0; x < LEVEL_WIDTH; x++) {
       uint8_t block = getBlockAt(level, x, y);
 
       if (block == E_PLAYER) {
         player = create_player(x, y);
+        rotatePlayer(0);
         return;
       }
 
@@ -64,139 +106,159 @@ uint8_t getBlockAt(const uint8_t level[], uint8_t x, uint8_t y) {
          & 0b1111;               // mask wanted bits
 }
 
-bool isSpawned(UID uid) {
-  for (uint8_t i = 0; i < num_entities; i++) {
-    if (entity[i].uid == uid) return true;
+// Faster than getBlockAt() when only the walls matter (see level_walls.h)
+bool isWall(const uint8_t walls[], uint8_t x, uint8_t y) {
+  if (x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) {
+    return false;
   }
 
-  return false;
+  return pgm_read_byte(walls + y * (LEVEL_WIDTH / 8) + x / 8) & pgm_read_byte(bit_mask + x % 8);
 }
 
-bool isStatic(UID uid) {
-  for (uint8_t i = 0; i < num_static_entities; i++) {
-    if (static_entity[i].uid == uid) return true;
+// Distance from x, y to the nearest wall, up to 3 (see level_distance.h)
+uint8_t getDistanceAt(const uint8_t distance[], uint8_t x, uint8_t y) {
+  if (x >= LEVEL_WIDTH || y >= LEVEL_HEIGHT) {
+    return 1;
   }
 
-  return false;
+  return pgm_read_byte(distance + (((LEVEL_HEIGHT - 1 - y) * LEVEL_WIDTH + x) / 4))
+         >> ((3 - x % 4) * 2)
+         & 0b11;
 }
 
-void spawnEntity(uint8_t type, uint8_t x, uint8_t y) {
-  // Limit the number of spawned entities
-  if (num_entities >= MAX_ENTITIES) {
-    return;
+bool isSpawned(UID uid) {
+  for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1)) {
+    if (entity_uid[i] == uid) return true;
   }
 
-  // todo: read static entity status
-  
+  return false;
+}
+
+// Returns the slot of the new entity, or NO_SLOT
+uint8_t spawnEntity(uint8_t type, uint8_t x, uint8_t y, uint8_t ordinal = NO_ORDINAL) {
+  uint8_t slot;
+
+  // Limit the number of spawned entities
   switch (type) {
     case E_ENEMY:
-      entity[num_entities] = create_enemy(x, y);
-      num_entities++;
+      slot = create_enemy(x, y);
       break;
 
     case E_KEY:
-      entity[num_entities] = create_key(x, y);
-      num_entities++;
+      slot = create_key(x, y);
       break;
 
     case E_MEDIKIT:
-      entity[num_entities] = create_medikit(x, y);
-      num_entities++;
+      slot = create_medikit(x, y);
       break;
-  }
-}
 
-void spawnFireball(double x, double y) {
-  // Limit the number of spawned entities
-  if (num_entities >= MAX_ENTITIES) {
-    return;
+    default:
+      return NO_SLOT;
   }
 
-  UID uid = create_uid(E_FIREBALL, x, y);
-  // Remove if already exists, don't throw anything. Not the best, but shouldn't happen too often
-  if (isSpawned(uid)) return;
-
-  // Calculate direction. 32 angles
-  int16_t dir = FIREBALL_ANGLES + atan2(y - player.pos.y, x - player.pos.x) / PI * FIREBALL_ANGLES;
-  if (dir < 0) dir += FIREBALL_ANGLES * 2;
-  entity[num_entities] = create_fireball(x, y, dir);
-  num_entities++;
+  if (slot != NO_SLOT) entity_ordinal[slot] = ordinal;
+  return slot;
 }
 
-void removeEntity(UID uid, bool makeStatic = false) {
-  uint8_t i = 0;
-  bool found = false;
+// Spawns the entities of the level around the player. Only the buckets in
+// reach are looked at (see level_entities.h). The world state (world.h)
+// keeps the dead and picked up ones away, and the dozed enemies where they
+// were
+void spawnEntities(const LevelEntity entities[], const uint8_t buckets[]) {
+  int8_t px = coords_cell(player.pos.x);
+  int8_t py = coords_cell(player.pos.y);
+  uint8_t bx0 = max(px - SPAWN_DISTANCE, 0) >> ENTITY_BUCKET_SHIFT;
+  uint8_t bx1 = min(px + SPAWN_DISTANCE, LEVEL_WIDTH - 1) >> ENTITY_BUCKET_SHIFT;
+  uint8_t by0 = max(py - SPAWN_DISTANCE, 0) >> ENTITY_BUCKET_SHIFT;
+  uint8_t by1 = min(py + SPAWN_DISTANCE, LEVEL_HEIGHT - 1) >> ENTITY_BUCKET_SHIFT;
+
+  for (uint8_t by = by0; by <= by1; by++) {
+    for (uint8_t bx = bx0; bx <= bx1; bx++) {
+      const uint8_t *bucket = buckets + by * ENTITY_BUCKETS_X + bx;
+      uint8_t end = pgm_read_byte(bucket + 1);
+
+      for (uint8_t i = pgm_read_byte(bucket); i < end; i++) {
+        if (world_gone(i)) continue;
+
+        LevelEntity e;
+        memcpy_P(&e, entities + i, sizeof(LevelEntity));
+        uint8_t x = e.x;
+        uint8_t y = e.y;
+
+        #if MAX_SAVED_ENEMIES > 0
+        SavedEnemy *saved = world_find(i);
+        if (saved != NULL) {
+          x = saved->x;
+          y = saved->y;
+        }
+        #endif
 
-  while (i < num_entities) {
-    if (!found && entity[i].uid == uid) {
-      // todo: doze it
-      found = true;
-      num_entities--;
-    }
+        int8_t dx = x - px;
+        int8_t dy = y - py;
+        if (dx * dx + dy * dy >= SPAWN_DISTANCE * SPAWN_DISTANCE) continue;
+        if (isSpawned(create_uid(e.type, e.x, e.y))) continue;
 
-    // displace entities
-    if (found) {
-      entity[i] = entity[i + 1];
-    }
+        uint8_t slot = spawnEntity(e.type, e.x, e.y, i);
 
-    i++;
+        #if MAX_SAVED_ENEMIES > 0
+        if (slot != NO_SLOT && saved != NULL) {
+          entity_pos[slot] = { coords_center(x), coords_center(y) };
+          entity_health[slot] = saved->health;
+          saved->ordinal = NO_ORDINAL;
+        }
+        #endif
+      }
+    }
   }
 }
 
-void removeStaticEntity(UID uid) {
-  uint8_t i = 0;
-  bool found = false;
-
-  while (i < num_static_entities) {
-    if (!found && static_entity[i].uid == uid) {
-      found = true;
-      num_static_entities--;
-    }
-
-    // displace entities
-    if (found) {
-      static_entity[i] = static_entity[i + 1];
-    }
+void spawnFireball(int16_t x, int16_t y) {
+  UID uid = create_uid(E_FIREBALL, coords_cell(x), coords_cell(y));
+  // Remove if already exists, don't throw anything. Not the best, but shouldn't happen too often
+  if (isSpawned(uid)) return;
 
-    i++;
-  }
+  // Calculate direction. 32 angles
+  int16_t dir = FIREBALL_ANGLES + atan2(y - player.pos.y, x - player.pos.x) / PI * FIREBALL_ANGLES;
+  if (dir < 0) dir += FIREBALL_ANGLES * 2;
+  // Limit the number of spawned entities
+  create_fireball(coords_cell(x), coords_cell(y), dir);
 }
 
-UID detectCollision(const uint8_t level[], Coords *pos, double relative_x, double relative_y, bool only_walls = false) {
+UID detectCollision(const uint8_t walls[], Coords *pos, int16_t relative_x, int16_t relative_y, bool only_walls = false) {
   // Wall collision
-  uint8_t round_x = int(pos->x + relative_x);
-  uint8_t round_y = int(pos->y + relative_y);
-  uint8_t block = getBlockAt(level, round_x, round_y);
+  uint8_t round_x = coords_cell(pos->x + relative_x);
+  uint8_t round_y = coords_cell(pos->y + relative_y);
 
-  if (block == E_WALL) {
+  if (isWall(walls, round_x, round_y)) {
     playSound(hit_wall_snd, HIT_WALL_SND_LEN);
-    return create_uid(block, round_x, round_y);
+    return create_uid(E_WALL, round_x, round_y);
   }
 
   if (only_walls) {
     return UID_null;
   }
 
-  // Entity collision
-  for (uint8_t i=0; i < num_entities; i++) {
-    // Don't collide with itself
-    if (&(entity[i].pos) == pos) {
-      continue;
-    }
+  // Entity collision. Only with the ALIVE enemies in the grid buckets
+  // around the new position (grid_build() first)
+  Coords target = { (int16_t) (pos->x + relative_x), (int16_t) (pos->y + relative_y) };
+  uint16_t buckets = grid_query(&target, ENEMY_COLLIDER_DIST * FX_ONE / DISTANCE_MULTIPLIER + 1);
 
-    uint8_t type = uid_get_type(entity[i].uid);
+  for (uint8_t b = 0; buckets != 0; b++, buckets >>= 1) {
+    if (!(buckets & 1)) continue;
 
-    // Only ALIVE enemy collision
-    if (type != E_ENEMY || entity[i].state == S_DEAD || entity[i].state == S_HIDDEN) {
-      continue;
-    }
+    for (uint8_t i = grid_head[b]; i != NO_SLOT; i = grid_next[i]) {
+      // Don't collide with itself
+      if (&(entity_pos[i]) == pos) {
+        continue;
+      }
 
-    Coords new_coords = { entity[i].pos.x - relative_x, entity[i].pos.y - relative_y };
-    uint8_t distance = coords_distance(pos, &new_coords);
+      Coords new_coords = { (int16_t) (entity_pos[i].x - relative_x), (int16_t) (entity_pos[i].y - relative_y) };
+      uint8_t distance = coords_distance(pos, &new_coords);
 
-    // Check distance and if it's getting closer
-    if (distance < ENEMY_COLLIDER_DIST && distance < entity[i].distance) {
-      return entity[i].uid;
+      // Check distance and if it's getting closer
+      if (distance < ENEMY_COLLIDER_DIST && distance < entity_distance[i]) {
+        return entity_uid[i];
+      }
     }
   }
 
@@ -207,28 +269,55 @@ UID detectCollision(const uint8_t level[], Coords *pos, double relative_x, doubl
 void fire() {
   playSound(shoot_snd, SHOOT_SND_LEN);
 
-  for (uint8_t i = 0; i < num_entities; i++) {
+  for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1)) {
     // Shoot only ALIVE enemies
-    if (uid_get_type(entity[i].uid) != E_ENEMY || entity[i].state == S_DEAD || entity[i].state == S_HIDDEN) {
+    if (uid_get_type(entity_uid[i]) != E_ENEMY || entity_state[i] == S_DEAD || entity_state[i] == S_HIDDEN) {
       continue;
     }
 
-    Coords transform = translateIntoView(&(entity[i].pos));
+    ViewCoords transform = translateIntoView(&(entity_pos[i]));
     if (abs(transform.x) < 20 && transform.y > 0) {
-      uint8_t damage = (double) min(GUN_MAX_DAMAGE, GUN_MAX_DAMAGE / (abs(transform.x) * entity[i].distance) / 5);
+      uint8_t damage = (double) min(GUN_MAX_DAMAGE, GUN_MAX_DAMAGE / (abs(transform.x) * entity_distance[i]) / 5);
       if (damage > 0) {
-        entity[i].health = max(0, entity[i].health - damage);
-        entity[i].state = S_HIT;
-        entity[i].timer = 4;
+        entity_health[i] = max(0, entity_health[i] - damage);
+        entity_state[i] = S_HIT;
+        entity_timer[i] = 4;
       }
     }
   }
 }
 
+// Turn the player. The camera vectors come from the heading tables, so
+// they don't drift like cumulative rotations did
+void rotatePlayer(int8_t amount) {
+  player.angle += amount;
+
+  // Q4.12 from the tables, down to Q8.8. No floats
+  uint8_t heading = player.angle >> CAMERA_ANGLE_SHIFT;
+  int16_t dir_x = camera_heading_cos(heading);
+  int16_t dir_y = camera_heading_sin(heading);
+
+  player.dir = {
+    (int16_t) (dir_x >> (FX_DIR_SHIFT - FX_SHIFT)),
+    (int16_t) (dir_y >> (FX_DIR_SHIFT - FX_SHIFT))
+  };
+  player.plane = {
+    (int16_t) ((int32_t) dir_y * CAMERA_PLANE_DIR >> (FX_DIR_SHIFT * 2 - FX_SHIFT)),
+    (int16_t) (- (int32_t) dir_x * CAMERA_PLANE_DIR >> (FX_DIR_SHIFT * 2 - FX_SHIFT))
+  };
+}
+
+// Take 40% of the way from the player velocity to the target. Rounded away
+// from the velocity, so it gets there
+void accelerate(int16_t target) {
+  int16_t step = (target - player.velocity) * 2;
+  player.velocity += (step + (step > 0 ? 4 : (step < 0 ? -4 : 0))) / 5;
+}
+
 // Update coords if possible. Return the collided uid, if any
-UID updatePosition(const uint8_t level[], Coords *pos, double relative_x, double relative_y, bool only_walls = false) {
-  UID collide_x = detectCollision(level, pos, relative_x, 0, only_walls);
-  UID collide_y = detectCollision(level, pos, 0, relative_y, only_walls);
+UID updatePosition(const uint8_t walls[], Coords *pos, int16_t relative_x, int16_t relative_y, bool only_walls = false) {
+  UID collide_x = detectCollision(walls, pos, relative_x, 0, only_walls);
+  UID collide_y = detectCollision(walls, pos, 0, relative_y, only_walls);
 
   if (!collide_x) pos->x += relative_x;
   if (!collide_y) pos->y += relative_y;
@@ -236,115 +325,117 @@ UID updatePosition(const uint8_t level[], Coords *pos, double relative_x, double
   return collide_x || collide_y || UID_null;
 }
 
-void updateEntities(const uint8_t level[]) {
-  uint8_t i = 0;
-  while (i < num_entities) {
+void updateEntities(const uint8_t walls[]) {
+  for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1)) {
     // update distance
-    entity[i].distance = coords_distance(&(player.pos), &(entity[i].pos));
+    entity_distance[i] = coords_distance(&(player.pos), &(entity_pos[i]));
 
-    // Run the timer. Works with actual frames.
-    // Todo: use delta here. But needs double type and more memory
-    if (entity[i].timer > 0) entity[i].timer--;
+    // Run the timer. Counts simulation steps
+    if (entity_timer[i] > 0) entity_timer[i]--;
 
     // too far away. put it in doze mode
-    if (entity[i].distance > MAX_ENTITY_DISTANCE) {
-      removeEntity(entity[i].uid);
-      // don't increase 'i', since current one has been removed
+    if (entity_distance[i] > MAX_ENTITY_DISTANCE) {
+      #if MAX_SAVED_ENEMIES > 0
+      if (uid_get_type(entity_uid[i]) == E_ENEMY && entity_state[i] != S_DEAD) {
+        world_save(i);
+      }
+      #endif
+      pool_remove(i);
       continue;
     }
 
     // bypass render if hidden
-    if (entity[i].state == S_HIDDEN) {
-      i++;
+    if (entity_state[i] == S_HIDDEN) {
       continue;
     }
 
-    uint8_t type = uid_get_type(entity[i].uid);
+    uint8_t type = uid_get_type(entity_uid[i]);
 
     switch (type) {
       case E_ENEMY: {
           // Enemy "IA"
-          if (entity[i].health == 0) {
-            if (entity[i].state != S_DEAD) {
-              entity[i].state = S_DEAD;
-              entity[i].timer = 6;
+          if (entity_health[i] == 0) {
+            if (entity_state[i] != S_DEAD) {
+              entity_state[i] = S_DEAD;
+              entity_timer[i] = 6;
+              world_remove(entity_ordinal[i]);
             }
-          } else  if (entity[i].state == S_HIT) {
-            if (entity[i].timer == 0) {
+          } else  if (entity_state[i] == S_HIT) {
+            if (entity_timer[i] == 0) {
               // Back to alert state
-              entity[i].state = S_ALERT;
-              entity[i].timer = 40;     // delay next fireball thrown
+              entity_state[i] = S_ALERT;
+              entity_timer[i] = 40;     // delay next fireball thrown
             }
-          } else if (entity[i].state == S_FIRING) {
-            if (entity[i].timer == 0) {
+          } else if (entity_state[i] == S_FIRING) {
+            if (entity_timer[i] == 0) {
               // Back to alert state
-              entity[i].state = S_ALERT;
-              entity[i].timer = 40;     // delay next fireball throwm
+              entity_state[i] = S_ALERT;
+              entity_timer[i] = 40;     // delay next fireball throwm
             }
           } else {
             // ALERT STATE
-            if (entity[i].distance > ENEMY_MELEE_DIST && entity[i].distance < MAX_ENEMY_VIEW) {
-              if (entity[i].state != S_ALERT) {
-                entity[i].state = S_ALERT;
-                entity[i].timer = 20;   // used to throw fireballs
+            if (entity_distance[i] > ENEMY_MELEE_DIST && entity_distance[i] < MAX_ENEMY_VIEW) {
+              if (entity_state[i] != S_ALERT) {
+                entity_state[i] = S_ALERT;
+                entity_timer[i] = 20;   // used to throw fireballs
               } else {
-                if (entity[i].timer == 0) {
+                if (entity_timer[i] == 0) {
                   // Throw a fireball
-                  spawnFireball(entity[i].pos.x, entity[i].pos.y);
-                  entity[i].state = S_FIRING;
-                  entity[i].timer = 6;
+                  spawnFireball(entity_pos[i].x, entity_pos[i].y);
+                  entity_state[i] = S_FIRING;
+                  entity_timer[i] = 6;
                 } else {
                   // move towards to the player.
                   updatePosition(
-                    level,
-                    &(entity[i].pos),
-                    sign(player.pos.x, entity[i].pos.x) * ENEMY_SPEED * delta,
-                    sign(player.pos.y, entity[i].pos.y) * ENEMY_SPEED * delta,
+                    walls,
+                    &(entity_pos[i]),
+                    sign(player.pos.x, entity_pos[i].x) * to_fixed(ENEMY_SPEED),
+                    sign(player.pos.y, entity_pos[i].y) * to_fixed(ENEMY_SPEED),
                     true
                   );
                 }
               }
-            } else if (entity[i].distance <= ENEMY_MELEE_DIST) {
-              if (entity[i].state != S_MELEE) {
+            } else if (entity_distance[i] <= ENEMY_MELEE_DIST) {
+              if (entity_state[i] != S_MELEE) {
                 // Preparing the melee attack
-                entity[i].state = S_MELEE;
-                entity[i].timer = 10;
-              } else if (entity[i].timer == 0) {
+                entity_state[i] = S_MELEE;
+                entity_timer[i] = 10;
+              } else if (entity_timer[i] == 0) {
                 // Melee attack
                 player.health = max(0, player.health - ENEMY_MELEE_DAMAGE);
-                entity[i].timer = 14;
+                entity_timer[i] = 14;
                 flash_screen = 1;
                 updateHud();
               }
             } else {
               // stand
-              entity[i].state = S_STAND;
+              entity_state[i] = S_STAND;
             }
           }
           break;
         }
 
       case E_FIREBALL: {
-          if (entity[i].distance < FIREBALL_COLLIDER_DIST) {
+          if (entity_distance[i] < FIREBALL_COLLIDER_DIST) {
             // Hit the player and disappear
             player.health = max(0, player.health - ENEMY_FIREBALL_DAMAGE);
             flash_screen = 1;
             updateHud();
-            removeEntity(entity[i].uid);
+            pool_remove(i);
             continue; // continue in the loop
           } else {
             // Move. Only collide with walls.
             // Note: using health to store the angle of the movement
             UID collided = updatePosition(
-              level,
-              &(entity[i].pos),
-              cos((double) entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
-              sin((double) entity[i].health / FIREBALL_ANGLES * PI) * FIREBALL_SPEED,
+              walls,
+              &(entity_pos[i]),
+              cos((double) entity_health[i] / FIREBALL_ANGLES * PI) * to_fixed(FIREBALL_SPEED),
+              sin((double) entity_health[i] / FIREBALL_ANGLES * PI) * to_fixed(FIREBALL_SPEED),
               true
             );
 
             if (collided) {
-              removeEntity(entity[i].uid);
+              pool_remove(i);
               continue; // continue in the entity check loop
             }
           }
@@ -352,10 +443,11 @@ void updateEntities(const uint8_t level[]) {
         }
 
       case E_MEDIKIT: {
-          if (entity[i].distance < ITEM_COLLIDER_DIST) {
+          if (entity_distance[i] < ITEM_COLLIDER_DIST) {
             // pickup
             playSound(medkit_snd, MEDKIT_SND_LEN);
-            entity[i].state = S_HIDDEN;
+            entity_state[i] = S_HIDDEN;
+            world_remove(entity_ordinal[i]);
             player.health = min(100, player.health + 50);
             updateHud();
             flash_screen = 1;
@@ -364,10 +456,11 @@ void updateEntities(const uint8_t level[]) {
         }
 
       case E_KEY: {
-          if (entity[i].distance < ITEM_COLLIDER_DIST) {
+          if (entity_distance[i] < ITEM_COLLIDER_DIST) {
             // pickup
             playSound(get_key_snd, GET_KEY_SND_LEN);
-            entity[i].state = S_HIDDEN;
+            entity_state[i] = S_HIDDEN;
+            world_remove(entity_ordinal[i]);
             player.keys++;
             updateHud();
             flash_screen = 1;
@@ -375,51 +468,96 @@ void updateEntities(const uint8_t level[]) {
           break;
         }
     }
-
-    i++;
   }
 }
 
 // The map raycaster. Based on https://lodev.org/cgtutor/raycasting.html
-void renderMap(const uint8_t level[], double view_height) {
-  UID last_uid;
+void renderMap(const uint8_t level_distance[], double view_height) {
+  // Every ray leaves the cell of the player. Maybe through empty cells
+  uint8_t start_skip = getDistanceAt(level_distance, coords_cell(player.pos.x), coords_cell(player.pos.y));
+  if (start_skip > 0) start_skip--;
+
+#ifdef FIXED_POINT_RAYCASTER
+  // Everything below is integer math
+  uint16_t pos_x = player.pos.x;
+  uint16_t pos_y = player.pos.y;
+  uint8_t heading = player.angle >> CAMERA_ANGLE_SHIFT;
+  int16_t fx_view_height = to_fixed(view_height);
+#else
+  double pos_x = (double) player.pos.x / FX_ONE;
+  double pos_y = (double) player.pos.y / FX_ONE;
+  double dir_x = (double) player.dir.x / FX_ONE;
+  double dir_y = (double) player.dir.y / FX_ONE;
+  double plane_x = (double) player.plane.x / FX_ONE;
+  double plane_y = (double) player.plane.y / FX_ONE;
+#endif
+
+  for (uint8_t x = 0; x < SCREEN_WIDTH; x += res_divider) {
+    uint8_t map_x = coords_cell(player.pos.x);
+    uint8_t map_y = coords_cell(player.pos.y);
+    int8_t step_x; 
+    int8_t step_y;
+
+#ifdef FIXED_POINT_RAYCASTER
+    // Ray setup is a table lookup. Reciprocals carry the ray direction sign
+    int16_t ray_x;
+    int16_t ray_y;
+    camera_ray_recip_at(heading, x * CAMERA_COLUMNS / SCREEN_WIDTH, &ray_x, &ray_y);
+    uint16_t delta_x = abs(ray_x);
+    uint16_t delta_y = abs(ray_y);
+    uint8_t frac_x = pos_x & (FX_ONE - 1);
+    uint8_t frac_y = pos_y & (FX_ONE - 1);
+    uint16_t side_x;
+    uint16_t side_y;
 
-  for (uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
+    if (ray_x < 0) {
+      step_x = -1;
+      side_x = (uint32_t) frac_x * delta_x >> FX_SHIFT;
+    } else {
+      step_x = 1;
+      side_x = (uint32_t) (FX_ONE - frac_x) * delta_x >> FX_SHIFT;
+    }
+
+    if (ray_y < 0) {
+      step_y = -1;
+      side_y = (uint32_t) frac_y * delta_y >> FX_SHIFT;
+    } else {
+      step_y = 1;
+      side_y = (uint32_t) (FX_ONE - frac_y) * delta_y >> FX_SHIFT;
+    }
+#else
     double camera_x = 2 * (double) x / SCREEN_WIDTH - 1;
-    double ray_x = player.dir.x + player.plane.x * camera_x;
-    double ray_y = player.dir.y + player.plane.y * camera_x;
-    uint8_t map_x = uint8_t(player.pos.x);
-    uint8_t map_y = uint8_t(player.pos.y);
-    Coords map_coords = { player.pos.x, player.pos.y };
+    double ray_x = dir_x + plane_x * camera_x;
+    double ray_y = dir_y + plane_y * camera_x;
     double delta_x = abs(1 / ray_x);
     double delta_y = abs(1 / ray_y);
-
-    int8_t step_x; 
-    int8_t step_y;
     double side_x;
     double side_y;
 
     if (ray_x < 0) {
       step_x = -1;
-      side_x = (player.pos.x - map_x) * delta_x;
+      side_x = (pos_x - map_x) * delta_x;
     } else {
       step_x = 1;
-      side_x = (map_x + 1.0 - player.pos.x) * delta_x;
+      side_x = (map_x + 1.0 - pos_x) * delta_x;
     }
 
     if (ray_y < 0) {
       step_y = -1;
-      side_y = (player.pos.y - map_y) * delta_y;
+      side_y = (pos_y - map_y) * delta_y;
     } else {
       step_y = 1;
-      side_y = (map_y + 1.0 - player.pos.y) * delta_y;
+      side_y = (map_y + 1.0 - pos_y) * delta_y;
     }
+#endif
 
-    // Wall detection
+    // Wall detection, on the distance field. The ray crosses the cells known
+    // to be empty without reading them
     uint8_t depth = 0;
+    uint8_t skip = start_skip;
     bool hit = 0;
     bool side; 
-    while (!hit && depth < MAX_RENDER_DEPTH) {
+    while (!hit && depth < render_depth) {
       if (side_x < side_y) {
         side_x += delta_x;
         map_x += step_x;
@@ -430,83 +568,130 @@ void renderMap(const uint8_t level[], double view_height) {
         side = 1;
       }
 
-      uint8_t block = getBlockAt(level, map_x, map_y);
+      depth++;
+      if (skip > 0) {
+        skip--;
+        continue;
+      }
 
-      if (block == E_WALL) {
+      skip = getDistanceAt(level_distance, map_x, map_y);
+      if (skip == 0) {
         hit = 1;
       } else {
-        // Spawning entities here, as soon they are visible for the
-        // player. Not the best place, but would be a very performance
-        // cost scan for them in another loop
-        if (block == E_ENEMY || (block & 0b00001000) /* all collectable items */) {
-          // Check that it's close to the player
-          if (coords_distance(&(player.pos), &map_coords) < MAX_ENTITY_DISTANCE) {
-            UID uid = create_uid(block, map_x, map_y);
-            if (last_uid != uid && !isSpawned(uid)) {
-              spawnEntity(block, map_x, map_y);
-              last_uid = uid;
-            }
-          }
-        }
+        skip--;
       }
-
-      depth++;
     }
 
     if (hit) {
+#ifdef FIXED_POINT_RAYCASTER
+      // Perpendicular distance is the side distance before the last step
+      uint16_t distance = max(FX_ONE, side ? side_y - delta_y : side_x - delta_x);
+      uint16_t inv_distance = fx_recip(distance, FX_SHIFT * 2);
+
+      // store zbuffer value for the column
+      for (uint8_t c = 0; c < res_divider; c += Z_RES_DIVIDER) {
+        zbuffer.set(x + c, distance);
+      }
+
+      // rendered line height
+      uint8_t line_height = RENDER_HEIGHT * inv_distance >> FX_SHIFT;
+      int8_t line_offset = ((int32_t) fx_view_height * inv_distance >> (FX_SHIFT * 2)) + RENDER_HEIGHT / 2;
+
+      renderVLine(
+        x,
+        line_offset - line_height / 2,
+        line_offset + line_height / 2,
+        GRADIENT_COUNT - distance / (MAX_RENDER_DEPTH * FX_ONE / GRADIENT_COUNT) - side * 2
+      );
+#else
       double distance;
       
       if (side == 0) {
-        distance = max(1, (map_x - player.pos.x + (1 - step_x) / 2) / ray_x);
+        distance = max(1, (map_x - pos_x + (1 - step_x) / 2) / ray_x);
       } else {
-        distance = max(1, (map_y - player.pos.y + (1 - step_y) / 2) / ray_y);
+        distance = max(1, (map_y - pos_y + (1 - step_y) / 2) / ray_y);
       }
 
       // store zbuffer value for the column
-      zbuffer[x / Z_RES_DIVIDER] = min(distance * DISTANCE_MULTIPLIER, 255);
+      for (uint8_t c = 0; c < res_divider; c += Z_RES_DIVIDER) {
+        zbuffer.set(x + c, to_fixed(distance));
+      }
 
       // rendered line height
       uint8_t line_height = RENDER_HEIGHT / distance;
 
-      drawVLine(
+      renderVLine(
         x,
         view_height / distance - line_height / 2 + RENDER_HEIGHT / 2,
         view_height / distance + line_height / 2 + RENDER_HEIGHT / 2,
         GRADIENT_COUNT - int(distance / MAX_RENDER_DEPTH * GRADIENT_COUNT) - side * 2
       );
+#endif
+    } else {
+      // No wall in range. Don't let the walls of the last frame hide sprites here
+      for (uint8_t c = 0; c < res_divider; c += Z_RES_DIVIDER) {
+        zbuffer.set(x + c, UINT16_MAX);
+      }
     }
   }
 }
 
-// Sort entities from far to close
-uint8_t sortEntities() {
-  uint8_t gap = num_entities;
-  bool swapped = false;
-  while (gap > 1 || swapped) {
-    //shrink factor 1.3
-    gap = (gap * 10) / 13;
-    if (gap == 9 || gap == 10) gap = 11;
-    if (gap < 1) gap = 1;
-    swapped = false;
-    for (uint8_t i = 0; i < num_entities - gap; i++)
-    {
-      uint8_t j = i + gap;
-      if (entity[i].distance < entity[j].distance)
-      {
-        swap(entity[i], entity[j]);
-        swapped = true;
-      }
+// Sort the entities in view from far to close into entity_order. It starts
+// from the order of the last frame, which is almost right, so the insertion
+// sort is close to O(n). The ones behind the camera or too far to draw are
+// left out first. The test is rough, renderEntities() makes the exact one
+void sortEntities() {
+  uint16_t visible = 0;
+  for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1)) {
+    if (entity_state[i] == S_HIDDEN) continue;
+
+    // Along the view direction
+    int16_t depth = (
+      (int32_t) (entity_pos[i].x - player.pos.x) * player.dir.x +
+      (int32_t) (entity_pos[i].y - player.pos.y) * player.dir.y
+    ) >> FX_SHIFT;
+    if (depth <= 0 || depth > (sprite_depth + 1) * FX_ONE) continue;
+
+    visible |= 1U << i;
+  }
+
+  // The ones still in view keep their place. Then the rest
+  uint8_t count = 0;
+  for (uint8_t o = 0; o < num_ordered; o++) {
+    uint8_t i = entity_order[o];
+    if (visible & (1U << i)) {
+      entity_order[count++] = i;
+      visible &= ~(1U << i);
     }
   }
+  for (uint8_t i = 0; visible != 0; i++) {
+    if (visible & (1U << i)) {
+      entity_order[count++] = i;
+      visible &= ~(1U << i);
+    }
+  }
+  num_ordered = count;
+
+  for (uint8_t o = 1; o < count; o++) {
+    uint8_t i = entity_order[o];
+    uint8_t distance = entity_distance[i];
+    uint8_t p = o;
+    while (p > 0 && entity_distance[entity_order[p - 1]] < distance) {
+      entity_order[p] = entity_order[p - 1];
+      p--;
+    }
+    entity_order[p] = i;
+  }
 }
 
-Coords translateIntoView(Coords *pos) {
+ViewCoords translateIntoView(Coords *pos) {
   //translate sprite position to relative to camera
-  double sprite_x = pos->x - player.pos.x;
-  double sprite_y = pos->y - player.pos.y;
+  double sprite_x = (double) (pos->x - player.pos.x) / FX_ONE;
+  double sprite_y = (double) (pos->y - player.pos.y) / FX_ONE;
 
-  //required for correct matrix multiplication
-  double inv_det = 1.0 / (player.plane.x * player.dir.y - player.dir.x * player.plane.y);
+  //required for correct matrix multiplication. The vectors are Q8.8, so
+  //the determinant comes FX_ONE^2 times bigger
+  double inv_det = (double) FX_ONE / ((int32_t) player.plane.x * player.dir.y - (int32_t) player.dir.x * player.plane.y);
   double transform_x = inv_det * (player.dir.y * sprite_x - player.dir.x * sprite_y);
   double transform_y = inv_det * (- player.plane.y * sprite_x + player.plane.x * sprite_y); // Z in screen
 
@@ -516,19 +701,18 @@ Coords translateIntoView(Coords *pos) {
 void renderEntities(double view_height) {
   sortEntities();
 
-  for (uint8_t i = 0; i < num_entities; i++) {
-    if (entity[i].state == S_HIDDEN) continue;
-
-    Coords transform = translateIntoView(&(entity[i].pos));
+  for (uint8_t o = 0; o < num_ordered; o++) {
+    uint8_t i = entity_order[o];
+    ViewCoords transform = translateIntoView(&(entity_pos[i]));
 
     // don´t render if behind the player or too far away
-    if (transform.y <= 0.1 || transform.y > MAX_SPRITE_DEPTH) {
+    if (transform.y <= 0.1 || transform.y > sprite_depth) {
       continue;
     }
 
     int16_t sprite_screen_x = HALF_WIDTH * (1.0 + transform.x / transform.y);
     int8_t sprite_screen_y = RENDER_HEIGHT / 2 + view_height / transform.y;
-    uint8_t type = uid_get_type(entity[i].uid);
+    uint8_t type = uid_get_type(entity_uid[i]);
 
     // don´t try to render if outside of screen
     // doing this pre-shortcut due int16 -> int8 conversion makes out-of-screen
@@ -540,33 +724,31 @@ void renderEntities(double view_height) {
     switch (type) {
       case E_ENEMY: {
           uint8_t sprite;
-          if (entity[i].state == S_ALERT) {
+          if (entity_state[i] == S_ALERT) {
             // walking
-            sprite = int(millis() / 500) % 2;
-          } else if (entity[i].state == S_FIRING) {
+            sprite = int(gameTime / 500) % 2;
+          } else if (entity_state[i] == S_FIRING) {
             // fireball
             sprite = 2;
-          } else if (entity[i].state == S_HIT) {
+          } else if (entity_state[i] == S_HIT) {
             // hit
             sprite = 3;
-          } else if (entity[i].state == S_MELEE) {
+          } else if (entity_state[i] == S_MELEE) {
             // melee atack
-            sprite = entity[i].timer > 10 ? 2 : 1;
-          } else if (entity[i].state == S_DEAD) {
+            sprite = entity_timer[i] > 10 ? 2 : 1;
+          } else if (entity_state[i] == S_DEAD) {
             // dying
-            sprite = entity[i].timer > 0 ? 3 : 4;
+            sprite = entity_timer[i] > 0 ? 3 : 4;
           } else {
             // stand
             sprite = 0;
           }
 
-          drawSprite(
+          renderSprite(
             sprite_screen_x - BMP_IMP_WIDTH * .5 / transform.y,
             sprite_screen_y - 8 / transform.y,
-            bmp_imp_bits,
-            bmp_imp_mask,
-            BMP_IMP_WIDTH,
-            BMP_IMP_HEIGHT,
+            bmp_imp_mips,
+            BMP_IMP_MIPS,
             sprite,
             transform.y
           );
@@ -574,13 +756,11 @@ void renderEntities(double view_height) {
         }
 
       case E_FIREBALL: {
-          drawSprite(
+          renderSprite(
             sprite_screen_x - BMP_FIREBALL_WIDTH / 2 / transform.y,
             sprite_screen_y - BMP_FIREBALL_HEIGHT / 2 / transform.y,
-            bmp_fireball_bits,
-            bmp_fireball_mask,
-            BMP_FIREBALL_WIDTH,
-            BMP_FIREBALL_HEIGHT,
+            bmp_fireball_mips,
+            BMP_FIREBALL_MIPS,
             0,
             transform.y
           );
@@ -588,13 +768,11 @@ void renderEntities(double view_height) {
         }
 
       case E_MEDIKIT: {
-          drawSprite(
+          renderSprite(
             sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
             sprite_screen_y + 5 / transform.y,
-            bmp_items_bits,
-            bmp_items_mask,
-            BMP_ITEMS_WIDTH,
-            BMP_ITEMS_HEIGHT,
+            bmp_items_mips,
+            BMP_ITEMS_MIPS,
             0,
             transform.y
           );
@@ -602,13 +780,11 @@ void renderEntities(double view_height) {
         }
 
       case E_KEY: {
-          drawSprite(
+          renderSprite(
             sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
             sprite_screen_y + 5 / transform.y,
-            bmp_items_bits,
-            bmp_items_mask,
-            BMP_ITEMS_WIDTH,
-            BMP_ITEMS_HEIGHT,
+            bmp_items_mips,
+            BMP_ITEMS_MIPS,
             1,
             transform.y
           );
@@ -619,9 +795,9 @@ void renderEntities(double view_height) {
 }
 
 void renderGun(uint8_t gun_pos, double amount_jogging) {
-  // jogging
-  char x = 48 + sin((double) millis() * JOGGING_SPEED) * 10 * amount_jogging;
-  char y = RENDER_HEIGHT - gun_pos + abs(cos((double) millis() * JOGGING_SPEED)) * 8 * amount_jogging;
+  // jogging. Uses the game time, so all the bands see the gun at the same place
+  char x = 48 + sin((double) gameTime * JOGGING_SPEED) * 10 * amount_jogging;
+  char y = RENDER_HEIGHT - gun_pos + abs(cos((double) gameTime * JOGGING_SPEED)) * 8 * amount_jogging;
 
   if (gun_pos > GUN_SHOT_POS - 2) {
     // Gun fire
@@ -656,31 +832,41 @@ void updateHud() {
 void renderStats() {
   display.clearRect(58, 58, 70, 6);
   drawText(114, 58, int(getActualFps()));
+  #if PROFILER == PROFILE_HUD
+  profile_hud(82, 58);
+  #else
   drawText(82, 58, num_entities);
+  #endif
   // drawText(94, 58, freeMemory());
+  // drawText(94, 58, display.getBytesSent() / 10); display.resetBytesSent(); // I2C bytes / 10 per frame
 }
 
 // Intro screen
 void loopIntro() {
-  display.drawBitmap(
-    (SCREEN_WIDTH - BMP_LOGO_WIDTH) / 2,
-    (SCREEN_HEIGHT - BMP_LOGO_HEIGHT) / 3,
-    bmp_logo_bits,
-    BMP_LOGO_WIDTH,
-    BMP_LOGO_HEIGHT,
-    1
-  );
-
   delay(1000);
-  drawText(SCREEN_WIDTH / 2 - 25, SCREEN_HEIGHT * .8, F("PRESS FIRE"));
-  display.display();
+
+  firstBand();
+  do {
+    display.drawBitmap(
+      (SCREEN_WIDTH - BMP_LOGO_WIDTH) / 2,
+      (SCREEN_HEIGHT - BMP_LOGO_HEIGHT) / 3,
+      bmp_logo_bits,
+      BMP_LOGO_WIDTH,
+      BMP_LOGO_HEIGHT,
+      1
+    );
+    drawText(SCREEN_WIDTH / 2 - 25, SCREEN_HEIGHT * .8, F("PRESS FIRE"));
+  } while (nextBand());
 
   // wait for fire
   while (!exit_scene) {
-    #ifdef SNES_CONTROLLER
-    getControllerData();
-    #endif
+    #ifdef INPUT_REPLAY
+    // Replays start on their own
+    jumpTo(GAME_PLAY);
+    #else
+    input_update();
     if (input_fire()) jumpTo(GAME_PLAY);
+    #endif
   };
 }
 
@@ -688,127 +874,132 @@ void loopGamePlay() {
   bool gun_fired = false;
   bool walkSoundToggle = false;
   uint8_t gun_pos = 0;
-  double rot_speed;
-  double old_dir_x;
-  double old_plane_x;
   double view_height;
   double jogging;
   uint8_t fade = GRADIENT_COUNT - 1;
 
   initializeLevel(sto_level_1);
+  record_start();
 
   do {
-    fps();
+    // Steps to simulate and keys. From the scheduler and the buttons, or the replay
+    uint8_t steps = frameSteps();
+    quality_update();
+
+    profile_begin(P_INPUT);
+    frameInput();
+    profile_end(P_INPUT);
+
+    // The last frame is streamed to the display while waiting for the step.
+    // Wait for it before anything is drawn in the buffer
+    profile_begin(P_DISPLAY);
+    display.waitDisplay();
+    profile_end(P_DISPLAY);
+
+    // Spawn what's around the player, every few frames
+    profile_begin(P_ENTITIES);
+    if (spawn_frames == 0) {
+      spawnEntities(sto_level_1_entities, sto_level_1_buckets);
+      spawn_frames = SPAWN_FRAMES;
+    }
+    spawn_frames--;
+    profile_end(P_ENTITIES);
+
+    // Simulate the steps due. All of them see the keys of the frame
+    while (steps--) {
+      gameTime += STEP_MS;
+
+      profile_begin(P_PLAYER);
+      // If the player is alive
+      if (player.health > 0) {
+        // Player speed
+        if (input_up()) {
+          accelerate(to_fixed(MOV_SPEED));
+        } else if (input_down()) {
+          accelerate(- to_fixed(MOV_SPEED));
+        } else {
+          player.velocity /= 2;
+        }
+        jogging = (double) abs(player.velocity) * MOV_SPEED_INV / FX_ONE;
 
-    // Clear only the 3d view
-    memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8));
+        // Player rotation
+        if (input_right()) {
+          rotatePlayer(- ROT_SPEED);
+        } else if (input_left()) {
+          rotatePlayer(ROT_SPEED);
+        }
 
-    #ifdef SNES_CONTROLLER
-    getControllerData();
-    #endif
+        view_height = abs(sin((double) gameTime * JOGGING_SPEED)) * 6 * jogging;
 
-    // If the player is alive
-    if (player.health > 0) {
-      // Player speed
-      if (input_up()) {
-        player.velocity += (MOV_SPEED - player.velocity) * .4;
-        jogging = abs(player.velocity) * MOV_SPEED_INV;
-      } else if (input_down()) {
-        player.velocity += (- MOV_SPEED - player.velocity) * .4;
-        jogging = abs(player.velocity) * MOV_SPEED_INV;
+        if(view_height > 5.9) {
+          if(sound == false) {
+            if(walkSoundToggle) {
+              playSound(walk1_snd, WALK1_SND_LEN);
+              walkSoundToggle = false;
+            } else {
+              playSound(walk2_snd, WALK2_SND_LEN);
+              walkSoundToggle = true;
+            }
+          }
+        }
+        // Update gun
+        if (gun_pos > GUN_TARGET_POS) {
+          // Right after fire
+          gun_pos -= 1;
+        } else if (gun_pos < GUN_TARGET_POS) {
+          // Showing up
+          gun_pos += 2;
+        } else if (!gun_fired && input_fire()) {
+          // ready to fire and fire pressed
+          gun_pos = GUN_SHOT_POS;
+          gun_fired = true;
+          fire();
+        } else if (gun_fired && !input_fire()) {
+          // just fired and restored position
+          gun_fired = false;
+        }
       } else {
-        player.velocity *= .5;
-        jogging = abs(player.velocity) * MOV_SPEED_INV;
-      }
+        // The player is dead
+        if (view_height > -10) view_height--;
+        else if (input_fire()) jumpTo(INTRO);
 
-      // Player rotation
-      if (input_right()) {
-        rot_speed = ROT_SPEED * delta;
-        old_dir_x = player.dir.x;
-        player.dir.x = player.dir.x * cos(-rot_speed) - player.dir.y * sin(-rot_speed);
-        player.dir.y = old_dir_x * sin(-rot_speed) + player.dir.y * cos(-rot_speed);
-        old_plane_x = player.plane.x;
-        player.plane.x = player.plane.x * cos(-rot_speed) - player.plane.y * sin(-rot_speed);
-        player.plane.y = old_plane_x * sin(-rot_speed) + player.plane.y * cos(-rot_speed);
-      } else if (input_left()) {
-        rot_speed = ROT_SPEED * delta;
-        old_dir_x = player.dir.x;
-        player.dir.x = player.dir.x * cos(rot_speed) - player.dir.y * sin(rot_speed);
-        player.dir.y = old_dir_x * sin(rot_speed) + player.dir.y * cos(rot_speed);
-        old_plane_x = player.plane.x;
-        player.plane.x = player.plane.x * cos(rot_speed) - player.plane.y * sin(rot_speed);
-        player.plane.y = old_plane_x * sin(rot_speed) + player.plane.y * cos(rot_speed);
+        if (gun_pos > 1) gun_pos -= 2;
       }
 
-      view_height = abs(sin((double) millis() * JOGGING_SPEED)) * 6 * jogging;
-
-      if(view_height > 5.9) {
-        if(sound == false) {
-          if(walkSoundToggle) {
-            playSound(walk1_snd, WALK1_SND_LEN);
-            walkSoundToggle = false;
-          } else {
-            playSound(walk2_snd, WALK2_SND_LEN);
-            walkSoundToggle = true;
-          }
-        }
-      }
-      // Update gun
-      if (gun_pos > GUN_TARGET_POS) {
-        // Right after fire
-        gun_pos -= 1;
-      } else if (gun_pos < GUN_TARGET_POS) {
-        // Showing up
-        gun_pos += 2;
-      } else if (!gun_fired && input_fire()) {
-        // ready to fire and fire pressed
-        gun_pos = GUN_SHOT_POS;
-        gun_fired = true;
-        fire();
-      } else if (gun_fired && !input_fire()) {
-        // just fired and restored position
-        gun_fired = false;
+      // Player movement
+      if (player.velocity != 0) {
+        grid_build();
+        updatePosition(
+          sto_level_1_walls,
+          &(player.pos),
+          (int32_t) player.dir.x * player.velocity >> FX_SHIFT,
+          (int32_t) player.dir.y * player.velocity >> FX_SHIFT
+        );
       }
-    } else {
-      // The player is dead
-      if (view_height > -10) view_height--;
-      else if (input_fire()) jumpTo(INTRO);
-
-      if (gun_pos > 1) gun_pos -= 2;
-    }
+      profile_end(P_PLAYER);
 
-    // Player movement
-    if (abs(player.velocity) > 0.003) {
-      updatePosition(
-        sto_level_1,
-        &(player.pos),
-        player.dir.x * player.velocity * delta,
-        player.dir.y * player.velocity * delta
-      );
-    } else {
-      player.velocity = 0;
+      // Update things
+      profile_begin(P_ENTITIES);
+      updateEntities(sto_level_1_walls);
+      profile_end(P_ENTITIES);
     }
 
-    // Update things
-    updateEntities(sto_level_1);
+    #ifndef SSD1306_BAND_PAGES
+    // Clear only the 3d view
+    memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8));
+    #endif
 
-    // Render stuff
-    renderMap(sto_level_1, view_height);
-    renderEntities(view_height);
-    renderGun(gun_pos, jogging);
+    // Render stuff. In band mode the walls and sprites are recorded here,
+    // and drawn for each band from the display list
+    clearDisplayList();
 
-    // Fade in effect
-    if (fade > 0) {
-      fadeScreen(fade);
-      fade--;
+    profile_begin(P_MAP);
+    renderMap(sto_level_1_distance, view_height);
+    profile_end(P_MAP);
 
-      if (fade == 0) {
-        // Only draw the hud after fade in effect
-        renderHud();
-      }
-    } else {
-      renderStats();
-    }
+    profile_begin(P_SPRITES);
+    renderEntities(view_height);
+    profile_end(P_SPRITES);
 
     // flash screen
     if (flash_screen > 0) {
@@ -820,7 +1011,40 @@ void loopGamePlay() {
 
     // Draw the frame
     display.invertDisplay(invert_screen);
-    display.display();
+
+    bool more_bands;
+    profile_begin(P_DISPLAY);
+    firstBand();
+    profile_end(P_DISPLAY);
+    do {
+      drawDisplayList();
+      renderGun(gun_pos, jogging);
+
+      profile_begin(P_HUD);
+      // Fade in effect
+      if (fade > 0) {
+        fadeScreen(fade);
+
+        if (fade == 1) {
+          // Only draw the hud after fade in effect
+          renderHud();
+        }
+      } else if (BAND_BOTTOM > RENDER_HEIGHT) {
+        #ifdef SSD1306_BAND_PAGES
+        // The band buffer doesn't keep the hud between frames
+        renderHud();
+        #endif
+        renderStats();
+      }
+      profile_end(P_HUD);
+
+      profile_begin(P_DISPLAY);
+      more_bands = nextBand();
+      profile_end(P_DISPLAY);
+    } while (more_bands);
+
+    if (fade > 0) fade--;
+    profile_frame();
 
     // Exit routine
     #ifdef SNES_CONTROLLER
@@ -831,9 +1055,120 @@ void loopGamePlay() {
       jumpTo(INTRO);
     }
   } while (!exit_scene);
+
+  record_stop();
 }
 
+#ifdef BENCHMARK
+// Runs the scenarios of bench.h and stops. See bench/
+// The map lookups of the raycaster and the collisions, over every cell. They
+// don't depend on the scenario, so they're timed in the first one only
+void benchLookups() {
+  volatile uint8_t sink;
+
+  bench_begin(BENCH_BLOCK_LOOKUP);
+  for (uint8_t y = 0; y < LEVEL_HEIGHT; y++) {
+    for (uint8_t x = 0; x < LEVEL_WIDTH; x++) {
+      sink = getBlockAt(sto_level_1, x, y) == E_WALL;
+    }
+  }
+  bench_end(BENCH_BLOCK_LOOKUP);
+
+  bench_begin(BENCH_WALL_LOOKUP);
+  for (uint8_t y = 0; y < LEVEL_HEIGHT; y++) {
+    for (uint8_t x = 0; x < LEVEL_WIDTH; x++) {
+      sink = isWall(sto_level_1_walls, x, y);
+    }
+  }
+  bench_end(BENCH_WALL_LOOKUP);
+
+  bench_begin(BENCH_FIELD_LOOKUP);
+  for (uint8_t y = 0; y < LEVEL_HEIGHT; y++) {
+    for (uint8_t x = 0; x < LEVEL_WIDTH; x++) {
+      sink = getDistanceAt(sto_level_1_distance, x, y);
+    }
+  }
+  bench_end(BENCH_FIELD_LOOKUP);
+}
+
+void loopBenchmark() {
+  static const uint8_t scenarios[][12] PROGMEM = {
+    #define BENCH_ROW(name, ...) { __VA_ARGS__ },
+    BENCH_SCENARIOS(BENCH_ROW)
+    #undef BENCH_ROW
+  };
+  uint8_t s[12];
+
+  // Stop millis() and the scheduler ticks, so the stages are timed alone
+  TIMSK0 &= ~(_BV(TOIE0) | _BV(OCIE0B));
+
+  for (uint8_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    memcpy_P(s, scenarios[i], sizeof(s));
+    GPIOR1 = i;
+
+    player = create_player(s[0], s[1]);
+    rotatePlayer(s[2]);
+    pool_reset();
+    world_reset();
+    for (uint8_t e = 3; e < sizeof(s); e += 3) {
+      if (s[e]) spawnEntity(s[e], s[e + 1], s[e + 2]);
+    }
+    spawnEntities(sto_level_1_entities, sto_level_1_buckets);
+
+    if (i == 0) benchLookups();
+
+    for (uint8_t frame = 0; frame < BENCH_FRAMES; frame++) {
+      // One step per frame
+      gameTime = frame * STEP_MS;
+
+      bench_begin(BENCH_UPDATE_ENTITIES);
+      updateEntities(sto_level_1_walls);
+      bench_end(BENCH_UPDATE_ENTITIES);
+
+      #ifndef SSD1306_BAND_PAGES
+      memset(display_buf, 0, SCREEN_WIDTH * (RENDER_HEIGHT / 8));
+      #endif
+      clearDisplayList();
+
+      bench_begin(BENCH_RENDER_MAP);
+      renderMap(sto_level_1_distance, 0);
+      bench_end(BENCH_RENDER_MAP);
+
+      bench_begin(BENCH_RENDER_ENTITIES);
+      renderEntities(0);
+      bench_end(BENCH_RENDER_ENTITIES);
+
+      bool more;
+      firstBand();
+      do {
+        #ifdef SSD1306_BAND_PAGES
+        bench_begin(BENCH_DISPLAY_LIST);
+        drawDisplayList();
+        bench_end(BENCH_DISPLAY_LIST);
+        #endif
+
+        bench_begin(BENCH_RENDER_GUN);
+        renderGun(GUN_TARGET_POS, 0);
+        bench_end(BENCH_RENDER_GUN);
+
+        bench_begin(BENCH_DISPLAY);
+        more = nextBand();
+        display.waitDisplay();
+        bench_end(BENCH_DISPLAY);
+      } while (more);
+    }
+  }
+
+  GPIOR2 = BENCH_DONE;
+  while (true);
+}
+#endif
+
 void loop(void) {
+  #ifdef BENCHMARK
+  loopBenchmark();
+  #endif
+
   switch (scene) {
     case INTRO: {
         loopIntro();
@@ -846,10 +1181,23 @@ void loop(void) {
   }
 
   // fade out effect
+  #ifdef SSD1306_BAND_PAGES
+  // There's no frame left to fade in band mode. Dim the display instead,
+  // and clear it
+  for (uint8_t i=0; i<GRADIENT_COUNT; i++) {
+    display.setContrast(0xCF - 0xCF * i / (GRADIENT_COUNT - 1));
+    delay(40);
+  }
+  firstBand();
+  while (nextBand());
+  display.setContrast(0xCF);
+  #else
   for (uint8_t i=0; i<GRADIENT_COUNT; i++) {
+    display.waitDisplay();
     fadeScreen(i, 0);
     display.display();
     delay(40);
   }
+  #endif
   exit_scene = false;
 }
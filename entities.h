@@ -4,10 +4,12 @@
 #include "types.h"
 
 // Shortcuts
+// dir and plane are left to rotatePlayer(0), which derives them from angle
 #define create_player(x, y)   { \
-    create_coords((double) x + 0.5, (double) y + 0.5), \
-    create_coords(1, 0), \
-    create_coords(0, -0.66), \
+    { coords_center(x), coords_center(y) }, \
+    { 0, 0 }, \
+    { 0, 0 }, \
+    0, \
     0, \
     100,  \
   }
@@ -28,33 +30,19 @@
 #define S_OPEN                7
 #define S_CLOSE               8
 
+#define NO_ORDINAL            0xFF
+
 struct Player { 
   Coords pos;
   Coords dir;
   Coords plane;
-  double velocity;
+  uint8_t angle;      // heading in 1/256 turns. dir and plane are derived from it
+  int16_t velocity;   // Q8.8 cells per step
   uint8_t health;
   uint8_t keys;  
 };
 
-struct Entity {
-  UID uid;
-  Coords pos;
-  uint8_t state;
-  uint8_t health;     // angle for fireballs
-  uint8_t distance;
-  uint8_t timer;
-};
-
-struct StaticEntity  { 
-  UID uid;
-  uint8_t x;
-  uint8_t y;
-  bool active;
-};
-
-Entity create_entity(uint8_t type, uint8_t x,  uint8_t y, uint8_t initialState, uint8_t initialHealth);
-StaticEntity create_static_entity(UID uid, uint8_t x,  uint8_t y, bool active);
+// The entities are in the pool (pool.h)
 
 #endif
 
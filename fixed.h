@@ -0,0 +1,75 @@
+#ifndef _fixed_h
+#define _fixed_h
+
+#include "hal.h"
+
+/*
+  Fixed point helpers for the raycaster, and the positions of the game.
+  Positions and distances use Q8.8 (8 integer bits, 8 fractional bits).
+  Ray directions use Q4.12, since they never go much further than 1.5
+*/
+#define FX_SHIFT            8
+#define FX_ONE              (1 << FX_SHIFT)
+#define FX_DIR_SHIFT        12
+#define FX_DIR_ONE          (1 << FX_DIR_SHIFT)
+
+#define to_fixed(d)         ((int16_t) ((d) * FX_ONE))
+
+// floor(sqrt(v)). Of a Q8.8 square (Q16.16) it's the Q8.8 root
+inline uint16_t fx_sqrt(uint32_t v) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v) bit >>= 2;
+
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+// 2^15 / m for m in [1, 2], 64 steps (+1 for interpolation)
+const static uint16_t PROGMEM fx_recip_table[65] = {
+  32768, 32264, 31775, 31301, 30840, 30394, 29959, 29537, 29127, 28728, 28340, 27962, 27594, 27236, 26887, 26546,
+  26214, 25891, 25575, 25267, 24966, 24672, 24385, 24105, 23831, 23564, 23302, 23046, 22795, 22550, 22310, 22075,
+  21845, 21620, 21400, 21183, 20972, 20764, 20560, 20361, 20165, 19973, 19784, 19600, 19418, 19240, 19065, 18893,
+  18725, 18559, 18396, 18236, 18079, 17924, 17772, 17623, 17476, 17332, 17190, 17050, 16913, 16777, 16644, 16513,
+  16384
+};
+
+// Returns 2^n / v, saturated to 0xFFFF. Table driven, no division.
+// Relative error is below 0.01%, so it's only limited by the output precision.
+inline uint16_t fx_recip(uint16_t v, uint8_t n) {
+  if (v == 0) return 0xFFFF;
+
+  // normalize so the leading bit is at bit 15. v = 2^e * m
+  int8_t e = 15;
+  while (!(v & 0x8000)) {
+    v <<= 1;
+    e--;
+  }
+
+  uint8_t i = (v >> 9) & 0b111111;
+  uint8_t frac = (v >> 2) & 0b1111111;
+  uint16_t a = pgm_read_word(fx_recip_table + i);
+  uint16_t b = pgm_read_word(fx_recip_table + i + 1);
+  uint32_t r = a - (((uint16_t) (a - b) * frac) >> 7);   // 2^15 / m
+
+  // 2^n / v = r * 2^(n - 15 - e)
+  int8_t shift = n - 15 - e;
+  if (shift >= 0) {
+    if (shift > 15) return 0xFFFF;
+    r <<= shift;
+    return r > 0xFFFF ? 0xFFFF : r;
+  }
+
+  return r >> -shift;
+}
+
+#endif
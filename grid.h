@@ -0,0 +1,62 @@
+#ifndef _grid_h
+#define _grid_h
+
+/*
+  Broadphase for the collisions with the entities (see detectCollision()).
+  The map is a uniform grid of squares of GRID_SIZE cells, folded into
+  GRID_BUCKETS buckets: a square goes to the bucket of its x and y modulo
+  GRID_FOLD. Any 2x2 squares have their own buckets, so a query over a box
+  smaller than a square reads each bucket once. The far squares sharing a
+  bucket are left out by the exact test of the caller.
+
+  Only the enemies alive collide, so only those are in it. The buckets are
+  lists linked through grid_next, by slot. grid_build() rebuilds it, in
+  O(n), before the queries of a step.
+*/
+#include "hal.h"
+#include "constants.h"
+#include "types.h"
+#include "pool.h"
+
+#define GRID_SHIFT            2           // Squares of 4x4 cells
+#define GRID_SIZE             (1 << GRID_SHIFT)
+#define GRID_FOLD             4
+#define GRID_BUCKETS          (GRID_FOLD * GRID_FOLD)
+
+uint8_t grid_head[GRID_BUCKETS];
+uint8_t grid_next[MAX_ENTITIES];
+
+// The bucket of the square of a Q8.8 position
+inline uint8_t grid_bucket(int16_t x, int16_t y) {
+  uint8_t square_x = x >> (FX_SHIFT + GRID_SHIFT);
+  uint8_t square_y = y >> (FX_SHIFT + GRID_SHIFT);
+  return (square_y % GRID_FOLD) * GRID_FOLD + square_x % GRID_FOLD;
+}
+
+void grid_build() {
+  memset(grid_head, NO_SLOT, sizeof(grid_head));
+
+  for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1)) {
+    if (uid_get_type(entity_uid[i]) != E_ENEMY || entity_state[i] == S_DEAD || entity_state[i] == S_HIDDEN) {
+      continue;
+    }
+
+    uint8_t bucket = grid_bucket(entity_pos[i].x, entity_pos[i].y);
+    grid_next[i] = grid_head[bucket];
+    grid_head[bucket] = i;
+  }
+}
+
+// The buckets of the squares the box around pos overlaps, a bit each.
+// radius is Q8.8, under GRID_SIZE cells, so its corners reach them all
+uint16_t grid_query(Coords *pos, int16_t radius) {
+  int16_t x0 = pos->x - radius;
+  int16_t y0 = pos->y - radius;
+  int16_t x1 = pos->x + radius;
+  int16_t y1 = pos->y + radius;
+
+  return 1U << grid_bucket(x0, y0) | 1U << grid_bucket(x1, y0)
+         | 1U << grid_bucket(x0, y1) | 1U << grid_bucket(x1, y1);
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef _hal_h
+#define _hal_h
+
+/*
+  Hardware abstraction. The engine only reaches the platform through:
+  - PROGMEM reads:  PROGMEM, pgm_read_byte(), pgm_read_word(), memcpy_P(), F()
+  - time:           millis(), delay(), micros() (profiler only)
+  - input:          pinMode(), digitalRead() (see input.cpp)
+  - display flush:  the SSD1306 transport (see SSD1306.h)
+  - sound output:   sound_init(), setFrequency(), off(), driven by soundTick() (see sound.h)
+
+  On the board these are the Arduino core and the AVR registers. With HOST
+  defined they come from host/host.h, for the native build in host/.
+*/
+#ifdef HOST
+#include "host/host.h"
+#else
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#endif
+
+#endif
@@ -0,0 +1,486 @@
+/*
+  Native (Linux) runner. Runs loopGamePlay() headless on the HAL in host.h.
+
+  doom-nano-host [-i script] [-n frames] [-o dir] [-s sound.log] [-g dir [-u]]
+    -i  Input script. One entry per line, # starts a comment:
+          <frames> <keys>   hold keys, any of U D L R F (fire), or - for none
+          pose <x> <y> <a>  move the player to a cell of the level, heading a
+                            (1/256 turns), before the next frame
+          snap <name>       a scene: the last frame is compared with the golden
+                            image (-g)
+        Keys are released when the script ends.
+    -n  Frames to run. Defaults to the script length, or 300.
+    -o  Write every frame to dir/frame_NNNNN.pbm
+    -s  Log the sound output, one "<ms> <frequency>" line per change.
+    -g  Compare the scenes with dir/<name>.pbm. Each mismatch writes
+        <name>.diff.ppm (in the -o dir, or here): removed pixels in red,
+        added in green. Exits with 1 if any differs.
+    -u  Write the scenes to the -g dir instead.
+
+  A frame is complete when the last byte of the screen is sent.
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "../constants.h"
+#include "../entities.h"
+#include "../SSD1306.h"
+
+#ifdef SNES_CONTROLLER
+#error "The host build only supports the key input"
+#endif
+
+#ifdef SSD1306_DELTA_FLUSH
+#error "The host build ends the frames on the last byte of the screen, which the delta flush skips"
+#endif
+
+#ifdef USE_INPUT_PULLUP
+#define PRESSED             LOW
+#else
+#define PRESSED             HIGH
+#endif
+
+#define MAX_SCRIPT          1024
+#define SOUND_TICK_MS       7           // Timer2 runs at ~140Hz on the board
+
+// From doom-nano.ino
+void setup(void);
+void loopGamePlay();
+void rotatePlayer(int8_t amount);
+extern Player player;
+extern uint8_t spawn_frames;
+
+HostSerial Serial;
+
+// Options
+static const char *output_dir = NULL;
+static const char *golden_dir = NULL;
+static bool update_golden = false;
+static FILE *sound_log = NULL;
+static uint32_t max_frames = 0;
+
+// Time
+static uint32_t clock_ms = 0;
+static uint32_t next_sound_tick = 0;
+
+static void runTimers() {
+  while (clock_ms >= next_sound_tick) {
+    next_sound_tick += SOUND_TICK_MS;
+    soundTick();
+  }
+}
+
+uint32_t millis() {
+  clock_ms++;
+  runTimers();
+  return clock_ms;
+}
+
+uint32_t micros() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void delay(uint32_t ms) {
+  clock_ms += ms;
+  runTimers();
+}
+
+void delayMicroseconds(uint32_t us) {}
+
+// Input
+enum { S_KEYS, S_POSE, S_SNAP };
+static struct {
+  uint8_t type;
+  uint32_t frames;
+  uint8_t keys;
+  uint8_t x, y, angle;
+  char name[32];
+} script[MAX_SCRIPT];
+static uint16_t script_len = 0;
+static uint16_t script_pos = 0;
+static uint32_t script_frames_left = 0;
+
+enum { KEY_UP = 1, KEY_DOWN = 2, KEY_LEFT = 4, KEY_RIGHT = 8, KEY_FIRE = 16 };
+static uint8_t keys = 0;
+
+static uint32_t loadScript(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    exit(1);
+  }
+
+  char line[128];
+  uint32_t total = 0;
+  while (fgets(line, sizeof(line), f)) {
+    char *comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    unsigned frames, x, y, angle;
+    char key_str[32];
+
+    if (script_len == MAX_SCRIPT) {
+      fprintf(stderr, "%s: more than %d entries\n", path, MAX_SCRIPT);
+      exit(1);
+    }
+
+    if (sscanf(line, "pose %u %u %u", &x, &y, &angle) == 3) {
+      script[script_len].type = S_POSE;
+      script[script_len].x = x;
+      script[script_len].y = y;
+      script[script_len].angle = angle;
+      script_len++;
+      continue;
+    }
+    if (sscanf(line, "snap %31s", key_str) == 1) {
+      script[script_len].type = S_SNAP;
+      strcpy(script[script_len].name, key_str);
+      script_len++;
+      continue;
+    }
+    if (sscanf(line, "%u %31s", &frames, key_str) != 2) continue;
+
+    uint8_t k = 0;
+    for (char *c = key_str; *c; c++) {
+      switch (*c) {
+        case 'U': k |= KEY_UP; break;
+        case 'D': k |= KEY_DOWN; break;
+        case 'L': k |= KEY_LEFT; break;
+        case 'R': k |= KEY_RIGHT; break;
+        case 'F': k |= KEY_FIRE; break;
+        case '-': break;
+        default:
+          fprintf(stderr, "%s: unknown key '%c'\n", path, *c);
+          exit(1);
+      }
+    }
+    script[script_len].type = S_KEYS;
+    script[script_len].frames = frames;
+    script[script_len].keys = k;
+    script_len++;
+    total += frames;
+  }
+  fclose(f);
+  return total;
+}
+
+static void snap(const char *name);
+
+// Runs the script up to the next frame
+static void runScript() {
+  if (script_frames_left > 0) script_frames_left--;
+
+  while (script_frames_left == 0) {
+    if (script_pos == script_len) {
+      keys = 0;
+      return;
+    }
+
+    switch (script[script_pos].type) {
+      case S_KEYS:
+        keys = script[script_pos].keys;
+        script_frames_left = script[script_pos].frames;
+        break;
+      case S_POSE:
+        player.pos = { coords_center(script[script_pos].x), coords_center(script[script_pos].y) };
+        player.velocity = 0;
+        player.angle = 0;
+        rotatePlayer(script[script_pos].angle);
+        // Spawn around the new place in this frame
+        spawn_frames = 0;
+        break;
+      case S_SNAP:
+        snap(script[script_pos].name);
+        break;
+    }
+    script_pos++;
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+int digitalRead(uint8_t pin) {
+  uint8_t k = 0;
+  switch (pin) {
+    case K_UP: k = KEY_UP; break;
+    case K_DOWN: k = KEY_DOWN; break;
+    case K_LEFT: k = KEY_LEFT; break;
+    case K_RIGHT: k = KEY_RIGHT; break;
+    case K_FIRE: k = KEY_FIRE; break;
+  }
+  return (keys & k) ? PRESSED : !PRESSED;
+}
+
+char *itoa(int value, char *str, int base) {
+  sprintf(str, "%d", value);
+  return str;
+}
+
+// Sound
+void sound_init() {}
+
+void setFrequency(uint16_t freq) {
+  if (sound_log) fprintf(sound_log, "%u %u\n", clock_ms, freq);
+}
+
+void off() {
+  if (sound_log) fprintf(sound_log, "%u 0\n", clock_ms);
+}
+
+// Display. Same addressing as the panel in horizontal mode
+static uint8_t gram[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+static uint8_t page_start = 0, page_end = SCREEN_HEIGHT / 8 - 1, page = 0;
+static uint8_t col_start = 0, col_end = SCREEN_WIDTH - 1, col = 0;
+static uint8_t command[3];
+static uint8_t command_len = 0;
+static bool inverted = false;
+static uint32_t frames = 0;
+static uint16_t mismatches = 0;
+static struct timespec start_time;
+
+static uint8_t commandArgs(uint8_t c) {
+  switch (c) {
+    case SSD1306_PAGEADDR:
+    case SSD1306_COLUMNADDR:
+      return 2;
+    case SSD1306_SETDISPLAYCLOCKDIV:
+    case SSD1306_SETMULTIPLEX:
+    case SSD1306_SETDISPLAYOFFSET:
+    case SSD1306_CHARGEPUMP:
+    case SSD1306_MEMORYMODE:
+    case SSD1306_SETCOMPINS:
+    case SSD1306_SETCONTRAST:
+    case SSD1306_SETPRECHARGE:
+    case SSD1306_SETVCOMDETECT:
+      return 1;
+  }
+  return 0;
+}
+
+static void runCommand() {
+  switch (command[0]) {
+    case SSD1306_PAGEADDR:
+      page_start = page = command[1] & 7;
+      page_end = command[2] & 7;
+      break;
+    case SSD1306_COLUMNADDR:
+      col_start = col = command[1] & 127;
+      col_end = command[2] & 127;
+      break;
+    case SSD1306_NORMALDISPLAY:
+      inverted = false;
+      break;
+    case SSD1306_INVERTDISPLAY:
+      inverted = true;
+      break;
+  }
+}
+
+#define PBM_SIZE            (SCREEN_WIDTH / 8 * SCREEN_HEIGHT)
+#define PBM_HEADER          "P4\n128 64\n"
+
+// The screen as it's seen, in PBM order (rows of 8 pixels per byte, 1 is black)
+static void screenImage(uint8_t *image) {
+  for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+    for (uint8_t x = 0; x < SCREEN_WIDTH; x += 8) {
+      uint8_t b = 0;
+      for (uint8_t i = 0; i < 8; i++) {
+        bool on = gram[(y / 8) * SCREEN_WIDTH + x + i] >> (y & 7) & 1;
+        if (on != inverted) b |= 0x80 >> i;
+      }
+      *image++ = b;
+    }
+  }
+}
+
+static void writeImage(const char *path, const uint8_t *image) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    exit(1);
+  }
+  fputs(PBM_HEADER, f);
+  fwrite(image, 1, PBM_SIZE, f);
+  fclose(f);
+}
+
+static bool readImage(const char *path, uint8_t *image) {
+  char header[sizeof(PBM_HEADER) - 1];
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+
+  bool ok = fread(header, 1, sizeof(header), f) == sizeof(header)
+    && !memcmp(header, PBM_HEADER, sizeof(header))
+    && fread(image, 1, PBM_SIZE, f) == PBM_SIZE;
+  fclose(f);
+  return ok;
+}
+
+// FNV-1a
+static uint32_t imageHash(const uint8_t *image) {
+  uint32_t hash = 2166136261u;
+  for (uint16_t i = 0; i < PBM_SIZE; i++) {
+    hash = (hash ^ image[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Pixels of the golden image in gray, removed ones in red and added ones in green
+static void writeDiff(const char *path, const uint8_t *golden, const uint8_t *image) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    exit(1);
+  }
+
+  fprintf(f, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+  for (uint16_t i = 0; i < PBM_SIZE * 8; i++) {
+    bool was = golden[i / 8] >> (7 - i % 8) & 1;
+    bool is = image[i / 8] >> (7 - i % 8) & 1;
+    static const uint8_t colors[4][3] = {
+      { 255, 255, 255 },    // white
+      { 220, 0, 0 },        // removed
+      { 0, 200, 0 },        // added
+      { 96, 96, 96 },       // black
+    };
+    fwrite(colors[was | is << 1], 1, 3, f);
+  }
+  fclose(f);
+}
+
+static void snap(const char *name) {
+  if (!golden_dir) return;
+
+  uint8_t image[PBM_SIZE], golden[PBM_SIZE];
+  char path[512];
+  screenImage(image);
+  snprintf(path, sizeof(path), "%s/%s.pbm", golden_dir, name);
+
+  if (update_golden) {
+    writeImage(path, image);
+    printf("%-16s %08x written\n", name, imageHash(image));
+    return;
+  }
+
+  if (!readImage(path, golden)) {
+    printf("%-16s %08x no golden image (%s)\n", name, imageHash(image), path);
+    mismatches++;
+    return;
+  }
+  if (!memcmp(image, golden, PBM_SIZE)) {
+    printf("%-16s %08x ok\n", name, imageHash(image));
+    return;
+  }
+
+  // Differences
+  uint16_t pixels = 0;
+  uint8_t x0 = SCREEN_WIDTH, y0 = SCREEN_HEIGHT, x1 = 0, y1 = 0;
+  for (uint16_t i = 0; i < PBM_SIZE * 8; i++) {
+    if ((image[i / 8] ^ golden[i / 8]) >> (7 - i % 8) & 1) {
+      uint8_t x = i % SCREEN_WIDTH, y = i / SCREEN_WIDTH;
+      pixels++;
+      x0 = min(x0, x); x1 = max(x1, x);
+      y0 = min(y0, y); y1 = max(y1, y);
+    }
+  }
+  snprintf(path, sizeof(path), "%s/%s.diff.ppm", output_dir ? output_dir : ".", name);
+  writeDiff(path, golden, image);
+  printf("%-16s %08x != %08x, %u pixels in (%u,%u)-(%u,%u), see %s\n",
+    name, imageHash(image), imageHash(golden), pixels, x0, y0, x1, y1, path);
+  mismatches++;
+}
+
+static void writeFrame() {
+  uint8_t image[PBM_SIZE];
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%05u.pbm", output_dir, frames);
+  screenImage(image);
+  writeImage(path, image);
+}
+
+static void finish() {
+  struct timespec end_time;
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+  fprintf(stderr, "%u frames, %u ms of game time in %.3f s (%.0fx real time)\n",
+    frames, clock_ms, seconds, seconds > 0 ? clock_ms / 1000.0 / seconds : 0);
+  if (sound_log) fclose(sound_log);
+  fflush(stdout);
+  if (mismatches) fprintf(stderr, "%u scene(s) differ\n", mismatches);
+  exit(mismatches ? 1 : 0);
+}
+
+static void frameDone() {
+  if (output_dir) writeFrame();
+  frames++;
+  runScript();
+  if (frames >= max_frames) finish();
+}
+
+void host_display_write(uint8_t cmd, const uint8_t *data, uint16_t n) {
+  while (n--) {
+    uint8_t b = *data++;
+
+    if (cmd & 0x40) {
+      gram[page * SCREEN_WIDTH + col] = b;
+      bool last = page == SCREEN_HEIGHT / 8 - 1 && col == SCREEN_WIDTH - 1;
+
+      if (++col > col_end) {
+        col = col_start;
+        if (++page > page_end) page = page_start;
+      }
+      if (last) frameDone();
+    } else {
+      // Commands may be split across messages
+      command[command_len++] = b;
+      if (command_len > commandArgs(command[0])) {
+        runCommand();
+        command_len = 0;
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *script_path = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "i:n:o:s:g:u")) != -1) {
+    switch (opt) {
+      case 'i': script_path = optarg; break;
+      case 'n': max_frames = atoi(optarg); break;
+      case 'o': output_dir = optarg; break;
+      case 'g': golden_dir = optarg; break;
+      case 'u': update_golden = true; break;
+      case 's':
+        sound_log = fopen(optarg, "w");
+        if (!sound_log) {
+          perror(optarg);
+          return 1;
+        }
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-i script] [-n frames] [-o dir] [-s sound.log] [-g dir [-u]]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  uint32_t script_frames = script_path ? loadScript(script_path) : 0;
+  if (max_frames == 0) max_frames = script_frames ? script_frames : 300;
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+  setup();
+  runScript();
+  loopGamePlay();   // Returns if the player leaves the game
+  finish();
+}
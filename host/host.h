@@ -0,0 +1,91 @@
+#ifndef _host_h
+#define _host_h
+
+/*
+  HAL of the native build (see hal.h and host.cpp). The subset of the
+  Arduino core used by the engine:
+  - Flash is plain memory.
+  - millis() is a virtual clock. It moves 1ms each time it's read, and
+    delay() adds to it. So the scheduler (scheduler.h) never sleeps and runs
+    are deterministic.
+    micros() is the real time, for the profiler (profile.h).
+  - digitalRead() returns the keys of the input script.
+  - The display is a HostTransport, which decodes the SSD1306 commands and
+    data like the panel does, and writes the frames as PBM.
+  - Sound output is logged.
+
+  Keep in mind that int is 32 bits and double 64 bits here (16 and 32 bits
+  on the board), so overflows and the double raycaster can differ.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define PROGMEM
+#define PGM_P               const char *
+#define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+#define pgm_read_word(addr) (*(const uint16_t *) (addr))
+#define memcpy_P            memcpy
+
+class __FlashStringHelper;
+#define F(s)                (reinterpret_cast<const __FlashStringHelper *>(s))
+
+#define F_CPU               16000000UL
+#define PI                  3.1415926535897932384626433832795
+#define HIGH                1
+#define LOW                 0
+#define INPUT               0
+#define OUTPUT              1
+#define INPUT_PULLUP        2
+
+typedef bool boolean;
+
+// Macros, like the AVR core, so mixed argument types behave the same
+#define min(a, b)           ((a) < (b) ? (a) : (b))
+#define max(a, b)           ((a) > (b) ? (a) : (b))
+#define abs(x)              ((x) > 0 ? (x) : -(x))
+
+// Time
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Input
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+char *itoa(int value, char *str, int base);
+
+struct HostSerial {
+  void begin(long baud) {}
+  void print(const __FlashStringHelper *str) { fputs((const char *) str, stderr); }
+  void print(char c) { fputc(c, stderr); }
+  void print(unsigned long n) { fprintf(stderr, "%lu", n); }
+  void println() { fputc('\n', stderr); }
+  void println(const __FlashStringHelper *str) { fprintf(stderr, "%s\n", (const char *) str); }
+  void println(unsigned long n) { fprintf(stderr, "%lu\n", n); }
+};
+extern HostSerial Serial;
+
+// Display flush
+void host_display_write(uint8_t cmd, const uint8_t *data, uint16_t n);
+
+struct HostTransport {
+  static constexpr uint8_t OVERHEAD = 2;    // Counted as I2C
+  static void begin(void) {}
+  static bool send(uint8_t cmd, uint8_t *data, uint16_t n) { host_display_write(cmd, data, n); return true; }
+  static void stream(uint8_t cmd, const uint8_t *data, uint16_t n) { host_display_write(cmd, data, n); }
+  static bool busy(void) { return false; }
+};
+
+// Sound output. soundTick() (sound.h) runs from the virtual clock
+void sound_init();
+void setFrequency(uint16_t freq);
+void off();
+void soundTick();
+
+#endif
@@ -1,4 +1,4 @@
-#include <Arduino.h>
+#include "hal.h"
 #include "input.h"
 #include "constants.h"
 
@@ -10,6 +10,38 @@
   #define INPUT_STATE HIGH
 #endif
 
+// Read once per frame by input_update(), so all the frame sees the same keys
+static uint8_t keys = 0;
+
+uint8_t input_keys() {
+  return keys;
+}
+
+// Replayed keys
+void input_set(uint8_t k) {
+  keys = k;
+}
+
+bool input_left() {
+  return keys & IN_LEFT;
+};
+
+bool input_right() {
+  return keys & IN_RIGHT;
+};
+
+bool input_up() {
+  return keys & IN_UP;
+};
+
+bool input_down() {
+  return keys & IN_DOWN;
+};
+
+bool input_fire() {
+  return keys & IN_FIRE;
+};
+
 #ifdef SNES_CONTROLLER
 uint16_t buttons = 0;
 
@@ -45,28 +77,20 @@ void getControllerData(void){
   }
 }
 
-bool input_left() {
-  return buttons & LEFT;
-};
-
-bool input_right() {
-  return buttons & RIGHT;
-};
+void input_update() {
+  getControllerData();
 
-bool input_up() {
-  return buttons & UP;
-};
-
-bool input_down() {
-  return buttons & DOWN;
-};
-
-bool input_fire() {
-  return buttons & Y;
-};
+  keys = 0;
+  if (buttons & UP) keys |= IN_UP;
+  if (buttons & DOWN) keys |= IN_DOWN;
+  if (buttons & LEFT) keys |= IN_LEFT;
+  if (buttons & RIGHT) keys |= IN_RIGHT;
+  if (buttons & Y) keys |= IN_FIRE;
+  if (buttons & START) keys |= IN_START;
+}
 
 bool input_start() {
-  return buttons & START;
+  return keys & IN_START;
 }
 #else
 
@@ -78,23 +102,12 @@ void input_setup() {
   pinMode(K_FIRE, INPUT_MODE);
 }
 
-bool input_left() {
-  return digitalRead(K_LEFT) == INPUT_STATE;
-};
-
-bool input_right() {
-  return digitalRead(K_RIGHT) == INPUT_STATE;
-};
-
-bool input_up() {
-  return digitalRead(K_UP) == INPUT_STATE;
-};
-
-bool input_down() {
-  return digitalRead(K_DOWN) == INPUT_STATE;
-};
-
-bool input_fire() {
-  return digitalRead(K_FIRE) == INPUT_STATE;
-};
+void input_update() {
+  keys = 0;
+  if (digitalRead(K_UP) == INPUT_STATE) keys |= IN_UP;
+  if (digitalRead(K_DOWN) == INPUT_STATE) keys |= IN_DOWN;
+  if (digitalRead(K_LEFT) == INPUT_STATE) keys |= IN_LEFT;
+  if (digitalRead(K_RIGHT) == INPUT_STATE) keys |= IN_RIGHT;
+  if (digitalRead(K_FIRE) == INPUT_STATE) keys |= IN_FIRE;
+}
 #endif
@@ -16,7 +16,18 @@ enum BUTTONS {
   RB = 0x0800
 };
 
+// Keys of a frame, as saved by the input recording (record.h)
+#define IN_UP       0x01
+#define IN_DOWN     0x02
+#define IN_LEFT     0x04
+#define IN_RIGHT    0x08
+#define IN_FIRE     0x10
+#define IN_START    0x20
+
 void input_setup();
+void input_update();
+uint8_t input_keys();
+void input_set(uint8_t keys);
 bool input_up();
 bool input_down();
 bool input_left();
@@ -25,7 +36,6 @@ bool input_fire();
 
 #ifdef SNES_CONTROLLER
 bool input_start();
-void getControllerData(void);
 #endif
 
 #endif
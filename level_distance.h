@@ -0,0 +1,77 @@
+#ifndef _level_distance_h
+#define _level_distance_h
+
+#include "hal.h"
+#include "level.h"
+
+/*
+  Generated by tools/gen_level_distance.py. Do not edit.
+
+  Distance fields of the levels (see getDistanceAt()). The raycaster
+  walks them instead of the levels. Its rays cross the cells within the
+  distance of the last one read without reading them.
+*/
+
+#define LEVEL_DISTANCE_SIZE (LEVEL_WIDTH / 4 * LEVEL_HEIGHT)
+
+const static uint8_t sto_level_1_distance[LEVEL_DISTANCE_SIZE] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x05, 0x50, 0x00, 0x00, 0x00, 0x00, 0x1A, 0xAA, 0xA9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0x90, 0x00, 0x05, 0x55, 0x55, 0x1B, 0xFF, 0xF9, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0x94, 0x00, 0x06, 0xAA, 0xA9, 0x5B, 0xFF, 0xF9, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x05, 0x54, 0x00, 0x06, 0x55, 0x55, 0x1B, 0xFF, 0xF9, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x06, 0x40, 0x00, 0x1A, 0xAA, 0xA9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x05, 0x55, 0x54, 0x06, 0x40, 0x00, 0x15, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0xAA, 0xA4, 0x06, 0x40, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0xFF, 0xE4, 0x56, 0x54, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0xFF, 0xE5, 0x6A, 0xA4, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0xFF, 0xE4, 0x55, 0x54, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0xAA, 0xA4, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x15, 0x05, 0x55, 0x54, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x15, 0x00, 0x15, 0x00, 0x00, 0x00, 0x01, 0x51, 0x59, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x04, 0x00, 0x19, 0x00, 0x00, 0x00, 0x01, 0x40, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x15, 0x00, 0x19, 0x00, 0x00, 0x00, 0x01, 0x40, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x15, 0x19, 0x00, 0x00, 0x00, 0x01, 0x40, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x59, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x15, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x19, 0x05, 0x55, 0x54, 0x00, 0x00, 0x00, 0x00, 0x55, 0x40, 0x00, 0x00, 0x00, 0x05, 0x55, 0x50,
+  0x19, 0x06, 0xAA, 0xA4, 0x00, 0x00, 0x01, 0x55, 0x6A, 0x55, 0x50, 0x00, 0x00, 0x06, 0xAA, 0x90,
+  0x19, 0x06, 0xFF, 0xE4, 0x00, 0x00, 0x01, 0xAA, 0xAE, 0xAA, 0x90, 0x00, 0x00, 0x06, 0xFF, 0x90,
+  0x19, 0x46, 0xFF, 0xE4, 0x00, 0x00, 0x01, 0xBF, 0xFF, 0xFF, 0x94, 0x55, 0x55, 0x46, 0xFF, 0x90,
+  0x1A, 0x56, 0xFF, 0xE4, 0x00, 0x00, 0x01, 0xBF, 0xFF, 0xFF, 0xA5, 0x6A, 0xAA, 0x56, 0xFF, 0x90,
+  0x19, 0x46, 0xFF, 0xE4, 0x00, 0x00, 0x01, 0xBF, 0xFF, 0xFF, 0x94, 0x56, 0x95, 0x46, 0xFF, 0x90,
+  0x19, 0x06, 0xFF, 0xE4, 0x00, 0x00, 0x01, 0xAA, 0xAE, 0xAA, 0x90, 0x05, 0x50, 0x06, 0xFF, 0x90,
+  0x19, 0x06, 0xAA, 0xA4, 0x00, 0x00, 0x01, 0x55, 0x6A, 0x55, 0x50, 0x01, 0x40, 0x06, 0xAA, 0x90,
+  0x19, 0x05, 0x55, 0x54, 0x00, 0x00, 0x00, 0x00, 0x55, 0x40, 0x00, 0x01, 0x40, 0x05, 0x55, 0x50,
+  0x19, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x19, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x19, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x19, 0x15, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x19, 0x59, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x19, 0x15, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x40, 0x44, 0x44, 0x00,
+  0x19, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x51, 0x55, 0x55, 0x00,
+  0x19, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x01, 0x95, 0xAA, 0xA9, 0x00,
+  0x19, 0x55, 0x59, 0x55, 0x41, 0x55, 0x40, 0x00, 0x19, 0x00, 0x00, 0x01, 0x51, 0x55, 0x55, 0x00,
+  0x1A, 0xAA, 0xAA, 0xAA, 0x55, 0xAA, 0x54, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x00,
+  0x15, 0x55, 0x55, 0x55, 0x41, 0x55, 0x40, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x14, 0x51, 0x40, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x01, 0x54, 0x51, 0x00, 0x00, 0x55, 0x15, 0x15, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x15, 0x50, 0x00, 0x00, 0x69, 0x59, 0x5A, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x19, 0x15, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x55, 0x19, 0x15, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x69, 0x59, 0x5A, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x19, 0x15, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x59, 0x55, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6A, 0xAA, 0xAA, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef _level_entities_h
+#define _level_entities_h
+
+#include "hal.h"
+#include "level.h"
+#include "types.h"
+
+/*
+  Generated by tools/gen_level_entities.py. Do not edit.
+
+  Enemies and items of the levels, by region of ENTITY_BUCKET_SIZE
+  cells (see spawnEntities()). Coords are cells, in level coords.
+*/
+
+#define ENTITY_BUCKET_SHIFT 3
+#define ENTITY_BUCKET_SIZE  (1 << ENTITY_BUCKET_SHIFT)
+#define ENTITY_BUCKETS_X    8
+#define ENTITY_BUCKETS_Y    8
+
+#define MAX_LEVEL_ENTITIES  30    // Of the level with the most
+
+struct LevelEntity {
+  uint8_t x;
+  uint8_t y;
+  uint8_t type;
+};
+
+const static LevelEntity sto_level_1_entities[] PROGMEM = {
+  { 38,  2, E_ENEMY },
+  { 39,  2, E_KEY },
+  {  5, 15, E_ENEMY },
+  { 14, 15, E_ENEMY },
+  { 22, 15, E_ENEMY },
+  {  6, 20, E_MEDIKIT },
+  {  1, 22, E_ENEMY },
+  {  3, 22, E_ENEMY },
+  { 34, 21, E_ENEMY },
+  { 55, 17, E_ENEMY },
+  { 58, 17, E_KEY },
+  { 11, 27, E_ENEMY },
+  { 10, 29, E_KEY },
+  {  9, 31, E_ENEMY },
+  { 30, 30, E_ENEMY },
+  { 38, 30, E_ENEMY },
+  { 48, 29, E_ENEMY },
+  { 59, 26, E_MEDIKIT },
+  { 58, 29, E_ENEMY },
+  {  2, 33, E_ENEMY },
+  {  2, 41, E_KEY },
+  { 10, 43, E_ENEMY },
+  { 10, 45, E_ENEMY },
+  { 19, 45, E_ENEMY },
+  { 22, 46, E_ENEMY },
+  { 31, 40, E_ENEMY },
+  { 37, 40, E_KEY },
+  { 34, 51, E_ENEMY },
+  { 37, 53, E_ENEMY },
+  { 42, 51, E_MEDIKIT },
+};
+
+const static uint8_t sto_level_1_buckets[ENTITY_BUCKETS_X * ENTITY_BUCKETS_Y + 1] PROGMEM = {
+   0,  0,  0,  0,  0,  2,  2,  2,
+   2,  3,  4,  5,  5,  5,  5,  5,
+   5,  8,  8,  8,  8,  9,  9, 10,
+  11, 11, 14, 14, 15, 16, 16, 17,
+  19, 20, 20, 20, 20, 20, 20, 20,
+  20, 21, 23, 25, 26, 27, 27, 27,
+  27, 27, 27, 27, 27, 29, 30, 30,
+  30, 30, 30, 30, 30, 30, 30, 30,
+  30
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef _level_walls_h
+#define _level_walls_h
+
+#include "hal.h"
+#include "level.h"
+
+/*
+  Generated by tools/gen_level_walls.py. Do not edit.
+
+  Wall bitmaps of the levels (see isWall()). The levels keep the rest
+  of the blocks.
+*/
+
+#define LEVEL_WALLS_SIZE    (LEVEL_WIDTH / 8 * LEVEL_HEIGHT)
+
+const static uint8_t sto_level_1_walls[LEVEL_WALLS_SIZE] PROGMEM = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x00, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x00, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x00, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x88, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x00, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFC, 0xFF, 0xF0, 0x88, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xFC, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF0, 0x88, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xF8, 0x3F, 0xF0, 0x00, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xE1, 0x2F, 0xF0, 0x88, 0x7F, 0xFF, 0xFF,
+  0xFF, 0xF9, 0x27, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x80, 0x00, 0x60, 0x7F, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x80, 0x00, 0x00, 0x1F, 0x8F, 0xFF, 0xF5, 0x5F,
+  0x80, 0x00, 0x60, 0x7F, 0x8F, 0xFE, 0x20, 0x0F,
+  0x8F, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x00, 0x0F,
+  0x8F, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x20, 0x0F,
+  0x88, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x75, 0x5F,
+  0x80, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x7F, 0xFF,
+  0x88, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x7F, 0xFF,
+  0x8F, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x7F, 0xFF,
+  0x8F, 0x8F, 0xFF, 0xFF, 0x8F, 0xFE, 0x7F, 0xFF,
+  0x8F, 0xDF, 0xFF, 0xFF, 0xDF, 0xFE, 0x7F, 0xFF,
+  0x8C, 0x01, 0xFF, 0xFF, 0x07, 0xFE, 0x7C, 0x03,
+  0x8C, 0x01, 0xFF, 0xE0, 0x00, 0x3E, 0x7C, 0x03,
+  0x8C, 0x01, 0xFF, 0xE0, 0x00, 0x3C, 0x3C, 0x03,
+  0x84, 0x01, 0xFF, 0xE0, 0x00, 0x10, 0x04, 0x03,
+  0x80, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x03,
+  0x84, 0x01, 0xFF, 0xE0, 0x00, 0x10, 0x04, 0x03,
+  0x8C, 0x01, 0xFF, 0xE0, 0x00, 0x3F, 0xFC, 0x03,
+  0x8C, 0x01, 0xFF, 0xE0, 0x00, 0x3F, 0xFC, 0x03,
+  0x8C, 0x01, 0xFF, 0xFF, 0x07, 0xFF, 0xFC, 0x03,
+  0x8F, 0xDF, 0xFF, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF,
+  0x88, 0x8F, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x80, 0x8F, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x88, 0x8F, 0xFF, 0xE7, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x8F, 0x8F, 0xFF, 0xE7, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xDF, 0x8F, 0xFF, 0xE7, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x8F, 0x8F, 0xFF, 0xE2, 0x03, 0xFF, 0xFF, 0xFF,
+  0x8F, 0xDF, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0x8C, 0x01, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x01, 0xFF, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x01, 0x01, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x00, 0x01, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x01, 0x01, 0xFF, 0x8F, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x01, 0xC7, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x01, 0xC7, 0xF8, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xC7, 0xF8, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFC, 0x1F, 0xC0, 0x08, 0x00, 0x8F, 0xFF, 0xFF,
+  0xFC, 0x1F, 0xC0, 0x00, 0x00, 0x0F, 0xFF, 0xFF,
+  0xFC, 0x3F, 0xC0, 0x08, 0x00, 0x8F, 0xFF, 0xFF,
+  0xFC, 0x3F, 0xFF, 0xF8, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xF8, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef _pool_h
+#define _pool_h
+
+/*
+  The entities, in a pool of MAX_ENTITIES slots. An entity keeps its slot
+  while it lives, so the slot is a handle to it that stays valid across
+  frames. Nothing gets shifted when one is removed:
+  - pool_alive has a bit per slot in use. The loops over the entities walk
+    it with pool_next(), and stop after the last one.
+  - The free slots are linked through their state field, from pool_free.
+
+  Adding and removing are O(1). The order of the slots means nothing: the
+  renderer sorts an index of them (see sortEntities()).
+
+  The fields are arrays indexed by the slot (entity_pos[i], entity_state[i]
+  ...), so the loops over a field read it in a row. 11 bytes per entity.
+*/
+#include "hal.h"
+#include "constants.h"
+#include "types.h"
+#include "entities.h"
+
+#if MAX_ENTITIES > 16
+#error "pool_alive has a bit per entity"
+#endif
+
+#define NO_SLOT               0xFF
+
+UID entity_uid[MAX_ENTITIES];
+Coords entity_pos[MAX_ENTITIES];
+uint8_t entity_state[MAX_ENTITIES];
+uint8_t entity_health[MAX_ENTITIES];      // angle for fireballs
+uint8_t entity_distance[MAX_ENTITIES];
+uint8_t entity_timer[MAX_ENTITIES];
+uint8_t entity_ordinal[MAX_ENTITIES];     // in the level entities (see world.h). NO_ORDINAL if not one of them
+
+uint16_t pool_alive = 0;
+uint8_t pool_free = NO_SLOT;
+uint8_t num_entities = 0;
+
+// Empties it
+void pool_reset() {
+  for (uint8_t i = 0; i < MAX_ENTITIES; i++) {
+    entity_state[i] = i + 1 < MAX_ENTITIES ? i + 1 : NO_SLOT;
+  }
+  pool_free = 0;
+  pool_alive = 0;
+  num_entities = 0;
+}
+
+// A new entity, in the middle of the cell. Returns its slot, or NO_SLOT
+// when full
+uint8_t create_entity(uint8_t type, uint8_t x, uint8_t y, uint8_t initialState, uint8_t initialHealth) {
+  uint8_t slot = pool_free;
+  if (slot == NO_SLOT) return NO_SLOT;
+
+  pool_free = entity_state[slot];
+  pool_alive |= 1U << slot;
+  num_entities++;
+
+  entity_uid[slot] = create_uid(type, x, y);
+  entity_pos[slot] = { coords_center(x), coords_center(y) };
+  entity_state[slot] = initialState;
+  entity_health[slot] = initialHealth;
+  entity_distance[slot] = 0;
+  entity_timer[slot] = 0;
+  entity_ordinal[slot] = NO_ORDINAL;
+  return slot;
+}
+
+void pool_remove(uint8_t slot) {
+  entity_state[slot] = pool_free;
+  pool_free = slot;
+  pool_alive &= ~(1U << slot);
+  num_entities--;
+}
+
+// The first slot in use from slot on, or MAX_ENTITIES. For the loops:
+// for (uint8_t i = pool_next(0); i < MAX_ENTITIES; i = pool_next(i + 1))
+uint8_t pool_next(uint8_t slot) {
+  if (slot >= MAX_ENTITIES) return MAX_ENTITIES;
+
+  uint16_t alive = pool_alive >> slot;
+  if (alive == 0) return MAX_ENTITIES;
+
+  while (!(alive & 1)) {
+    alive >>= 1;
+    slot++;
+  }
+  return slot;
+}
+
+#endif
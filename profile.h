@@ -0,0 +1,133 @@
+#ifndef _profile_h
+#define _profile_h
+
+/*
+  Per-stage profiler of the game loop. Opt-in with PROFILER (constants.h).
+  The stages are timed with micros(), which reads Timer0, free running for
+  millis() (4us, or 64 cycles, of resolution). Every PROFILE_FRAMES frames
+  the min, avg and max cycles per frame of each stage are reported:
+  - PROFILE_SERIAL: a "<stage> <min> <avg> <max>" line per stage
+  - PROFILE_HUD:    the avg of one stage at a time in the stats area, as its
+                    initial and the time in 0.1ms. The next stage is shown
+                    on the next report
+
+  A stage timed several times in a frame (the bands) adds up. Interrupts
+  (display stream, sound) count in the stage they interrupt.
+
+  Without PROFILER the markers are empty, so they cost nothing.
+*/
+#include "hal.h"
+#include "constants.h"
+
+#define PROFILE_SERIAL        1
+#define PROFILE_HUD           2
+
+// Stages
+#define P_INPUT               0
+#define P_PLAYER              1
+#define P_ENTITIES            2
+#define P_MAP                 3
+#define P_SPRITES             4
+#define P_HUD                 5
+#define P_DISPLAY             6
+#define P_STAGES              7
+
+#define PROFILE_FRAMES        32
+#define PROFILE_BAUD          115200
+#define CYCLES_PER_US         (F_CPU / 1000000)
+
+#ifdef PROFILER
+
+struct ProfileStage {
+  uint16_t frame;             // us, in the current frame
+  uint16_t min;
+  uint16_t max;
+  uint32_t total;
+};
+
+const char profile_names[P_STAGES][9] PROGMEM = {
+  "INPUT", "PLAYER", "ENTITIES", "MAP", "SPRITES", "HUD", "DISPLAY"
+};
+
+ProfileStage profile_stage[P_STAGES];
+uint16_t profile_start;
+uint8_t profile_frames = 0;
+#if PROFILER == PROFILE_HUD
+uint8_t profile_hud_stage = 0;
+uint16_t profile_hud_avg = 0;
+#endif
+
+#define profile_begin(stage)  (profile_start = micros())
+#define profile_end(stage)    (profile_stage[stage].frame += (uint16_t) micros() - profile_start)
+
+void profile_reset() {
+  for (uint8_t i = 0; i < P_STAGES; i++) {
+    profile_stage[i] = { 0, UINT16_MAX, 0, 0 };
+  }
+  profile_frames = 0;
+}
+
+void profile_setup() {
+  #if PROFILER == PROFILE_SERIAL
+  Serial.begin(PROFILE_BAUD);
+  #endif
+  profile_reset();
+}
+
+void profile_report() {
+  #if PROFILER == PROFILE_SERIAL
+  for (uint8_t i = 0; i < P_STAGES; i++) {
+    ProfileStage *s = &profile_stage[i];
+    Serial.print((const __FlashStringHelper *) profile_names[i]);
+    Serial.print(' ');
+    Serial.print((uint32_t) s->min * CYCLES_PER_US);
+    Serial.print(' ');
+    Serial.print(s->total / PROFILE_FRAMES * CYCLES_PER_US);
+    Serial.print(' ');
+    Serial.println((uint32_t) s->max * CYCLES_PER_US);
+  }
+  Serial.println();
+  #else
+  profile_hud_avg = profile_stage[profile_hud_stage].total / PROFILE_FRAMES;
+  profile_hud_stage = (profile_hud_stage + 1) % P_STAGES;
+  #endif
+}
+
+// Call once per frame
+void profile_frame() {
+  for (uint8_t i = 0; i < P_STAGES; i++) {
+    ProfileStage *s = &profile_stage[i];
+    if (s->frame < s->min) s->min = s->frame;
+    if (s->frame > s->max) s->max = s->frame;
+    s->total += s->frame;
+    s->frame = 0;
+  }
+
+  if (++profile_frames == PROFILE_FRAMES) {
+    profile_report();
+    profile_reset();
+  }
+}
+
+#if PROFILER == PROFILE_HUD
+// Stage initial and avg time in 0.1ms, 25 pixels wide
+void profile_hud(uint8_t x, uint8_t y) {
+  char buf[6];
+  uint8_t shown = (profile_hud_stage + P_STAGES - 1) % P_STAGES;
+
+  drawChar(x, y, pgm_read_byte(&profile_names[shown][0]));
+  itoa(profile_hud_avg / 100, buf, 10);
+  drawText(x + 6, y, buf);
+}
+#endif
+
+#else
+
+#define profile_begin(stage)
+#define profile_end(stage)
+#define profile_setup()
+#define profile_frame()
+
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef _quality_h
+#define _quality_h
+
+/*
+  Adaptive quality. With QUALITY_GOVERNOR (constants.h) the render settings
+  are a level of quality_levels, picked at runtime to hold the target fps:
+  - res_divider:  screen columns per ray. 1, 2 or 4 times QUALITY_RES, the
+                  columns per ray of the camera tables (camera.h). No rung
+                  can be finer than those
+  - render_depth: blocks a ray walks before it gives up
+  - sprite_depth: sprites further away aren't drawn
+  - sprite_step:  screen columns per sprite column sampled
+
+  Every QUALITY_FRAMES frames the average busy time of a frame (scheduler.h,
+  the sleep left out) is compared with the target. Over it, the next level
+  down is taken. Under QUALITY_HEADROOM percent of it, the next level up.
+  The gap between both keeps it from swinging between two levels.
+
+  Without QUALITY_GOVERNOR the settings are the constants, and the code
+  using them compiles as before.
+*/
+#include "hal.h"
+#include "constants.h"
+#include "camera.h"
+#include "scheduler.h"
+
+// The replays time builds against each other (record.h). The governor
+// would answer a slower build with a cheaper render, and hide it, so the
+// recordings and replays render at fixed, full quality
+#if defined(INPUT_RECORD) || defined(INPUT_REPLAY)
+#undef QUALITY_GOVERNOR
+#endif
+
+#ifdef QUALITY_GOVERNOR
+
+#define QUALITY_RES           (SCREEN_WIDTH / CAMERA_COLUMNS)
+#define QUALITY_FRAMES        8
+#define QUALITY_HEADROOM      70          // Percent of the target
+#define QUALITY_TARGET_TICKS  (1000000UL / ((uint32_t) TICK_US * QUALITY_GOVERNOR))
+
+struct QualityLevel {
+  uint8_t res_divider;
+  uint8_t render_depth;
+  uint8_t sprite_depth;
+  uint8_t sprite_step;
+};
+
+// From the best to the cheapest
+const static QualityLevel PROGMEM quality_levels[] = {
+  { QUALITY_RES,     MAX_RENDER_DEPTH,     MAX_SPRITE_DEPTH,     1 },
+  { QUALITY_RES,     MAX_RENDER_DEPTH - 2, MAX_SPRITE_DEPTH,     2 },
+  { QUALITY_RES * 2, MAX_RENDER_DEPTH - 2, MAX_SPRITE_DEPTH - 1, 2 },
+  { QUALITY_RES * 2, MAX_RENDER_DEPTH - 4, MAX_SPRITE_DEPTH - 2, 2 },
+  { QUALITY_RES * 4, MAX_RENDER_DEPTH - 4, MAX_SPRITE_DEPTH - 2, 2 },
+};
+#define QUALITY_LEVELS        (sizeof(quality_levels) / sizeof(QualityLevel))
+
+QualityLevel quality = { QUALITY_RES, MAX_RENDER_DEPTH, MAX_SPRITE_DEPTH, 1 };
+uint8_t quality_level = 0;
+uint8_t quality_frames = 0;
+uint16_t quality_busy = 0;
+
+#define res_divider           (quality.res_divider)
+#define render_depth          (quality.render_depth)
+#define sprite_depth          (quality.sprite_depth)
+#define sprite_step           (quality.sprite_step)
+
+void quality_set(uint8_t level) {
+  quality_level = level;
+  memcpy_P(&quality, quality_levels + level, sizeof(QualityLevel));
+}
+
+// Call once per frame, before rendering
+void quality_update() {
+  quality_busy += busy_ticks;
+  if (++quality_frames < QUALITY_FRAMES) return;
+
+  uint16_t busy = quality_busy / QUALITY_FRAMES;
+  if (busy > QUALITY_TARGET_TICKS && quality_level < QUALITY_LEVELS - 1) {
+    quality_set(quality_level + 1);
+  } else if (busy < QUALITY_TARGET_TICKS * QUALITY_HEADROOM / 100 && quality_level > 0) {
+    quality_set(quality_level - 1);
+  }
+
+  quality_frames = 0;
+  quality_busy = 0;
+}
+
+#else
+
+#define res_divider           RES_DIVIDER
+#define render_depth          MAX_RENDER_DEPTH
+#define sprite_depth          MAX_SPRITE_DEPTH
+#define sprite_step           1
+#define quality_set(level)
+#define quality_update()
+
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef _record_h
+#define _record_h
+
+/*
+  Input recording and replay. With INPUT_RECORD (constants.h) the keys and
+  the simulation steps of every frame of the game are saved. With
+  INPUT_REPLAY they are read back instead of the buttons and the scheduler,
+  so the game runs the same path, with no frame limit. Each game of the replay reports its
+  frames and time over Serial, so builds can be compared:
+    REPLAY <frames> <ms>
+
+  Stream: RECORD_MAGIC, then 3 bytes entries of frames (1-255), keys (IN_*
+  of input.h) and steps (scheduler.h). The frames with the same keys and
+  steps share an entry. A 0 frames entry ends it.
+  Storage:
+  - RECORD_EEPROM: from address 0. The 1KB of the ATmega328P fit 340 entries,
+    the recording stops there
+  - RECORD_SERIAL: written and read over Serial, raw, at RECORD_BAUD. The
+    output of a recording can be sent back as is to replay it
+
+  Each game overwrites the recording. It starts from the same state every
+  time (initializeLevel), so the replay of any game of a session plays the same.
+*/
+#include "hal.h"
+#include "constants.h"
+#include "input.h"
+#include "scheduler.h"
+
+#define RECORD_EEPROM         1
+#define RECORD_SERIAL         2
+
+#define RECORD_MAGIC          0xD5
+#define RECORD_BAUD           115200
+
+#if defined(INPUT_RECORD) && defined(INPUT_REPLAY)
+#error "Either record or replay the input"
+#endif
+
+#if defined(INPUT_RECORD) || defined(INPUT_REPLAY)
+
+#ifdef HOST
+#error "The host build takes the input from its scripts"
+#endif
+
+#ifdef INPUT_RECORD
+#define RECORD_STORAGE        INPUT_RECORD
+#else
+#define RECORD_STORAGE        INPUT_REPLAY
+#endif
+
+#if RECORD_STORAGE == RECORD_SERIAL && PROFILER == PROFILE_SERIAL
+#error "The profiler and the input recording can't share the Serial"
+#endif
+
+#if RECORD_STORAGE == RECORD_EEPROM
+#include <avr/eeprom.h>
+#endif
+
+// Current entry
+uint8_t record_frames = 0;
+uint8_t record_keys;
+uint8_t record_steps;
+uint16_t record_addr;
+#ifdef INPUT_RECORD
+uint8_t record_frame_steps;
+#endif
+
+void record_setup() {
+  Serial.begin(RECORD_BAUD);
+}
+
+void record_write(uint8_t b) {
+  #if RECORD_STORAGE == RECORD_EEPROM
+  eeprom_update_byte((uint8_t *) record_addr++, b);
+  #else
+  Serial.write(b);
+  #endif
+}
+
+uint8_t record_read() {
+  #if RECORD_STORAGE == RECORD_EEPROM
+  return eeprom_read_byte((const uint8_t *) record_addr++);
+  #else
+  while (!Serial.available());
+  return Serial.read();
+  #endif
+}
+
+#ifdef INPUT_RECORD
+
+void record_start() {
+  record_addr = 0;
+  record_frames = 0;
+  record_write(RECORD_MAGIC);
+}
+
+void record_flush() {
+  if (record_frames == 0) return;
+
+  #if RECORD_STORAGE == RECORD_EEPROM
+  // Full. Keep room for the end
+  if (record_addr + 4 > E2END + 1) {
+    record_frames = 0;
+    return;
+  }
+  #endif
+
+  record_write(record_frames);
+  record_write(record_keys);
+  record_write(record_steps);
+  record_frames = 0;
+}
+
+void record_stop() {
+  record_flush();
+  record_write(0);
+}
+
+uint8_t frameSteps() {
+  return record_frame_steps = waitFrame();
+}
+
+void frameInput() {
+  input_update();
+
+  uint8_t keys = input_keys();
+  if (keys != record_keys || record_frame_steps != record_steps || record_frames == 255) {
+    record_flush();
+    record_keys = keys;
+    record_steps = record_frame_steps;
+  }
+  record_frames++;
+}
+
+#else
+
+void jumpTo(uint8_t target_scene);
+
+uint16_t replay_frames;
+uint32_t replay_start;
+
+void record_start() {
+  record_addr = 0;
+  record_frames = 0;
+  replay_frames = 0;
+  replay_start = millis();
+
+  if (record_read() != RECORD_MAGIC) {
+    Serial.println(F("NO RECORDING"));
+    while (true);
+  }
+}
+
+void record_stop() {
+  Serial.print(F("REPLAY "));
+  Serial.print(replay_frames);
+  Serial.print(' ');
+  Serial.println(millis() - replay_start);
+}
+
+uint8_t frameSteps() {
+  if (record_frames == 0) {
+    record_frames = record_read();
+    if (record_frames == 0) {
+      // The end. Leave the game
+      input_set(0);
+      jumpTo(INTRO);
+      return 0;
+    }
+    record_keys = record_read();
+    record_steps = record_read();
+  }
+  return record_steps;
+}
+
+void frameInput() {
+  if (record_frames == 0) return;
+  input_set(record_keys);
+  record_frames--;
+  replay_frames++;
+}
+
+#endif
+
+#else
+
+#define record_setup()
+#define record_start()
+#define record_stop()
+#define frameSteps()          waitFrame()
+#define frameInput()          input_update()
+
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef _scheduler_h
+#define _scheduler_h
+
+/*
+  Frame scheduler. The Timer0 compare B interrupt ticks every 1.024ms (Timer0
+  runs free for millis(), the compare match only adds an interrupt to its
+  period). The game is simulated in fixed steps of STEP_TICKS, apart from the
+  rendering: each frame runs the steps due since the last one, up to
+  MAX_STEPS, and then renders once. When the frame is early it waits for the
+  next step in idle sleep. The timers and the TWI/SPI stream keep running
+  and wake it up.
+
+  Subsystems with work that can wait ask frameBudget() for the ticks left
+  before the next step is due. The quality governor (quality.h) reads how
+  long the last frame was busy.
+
+  On the host build the ticks are millis(), and there's no sleep.
+*/
+#include "hal.h"
+#include "constants.h"
+
+#ifndef HOST
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#define TICK_US               1024
+#else
+#define TICK_US               1000
+#endif
+
+#define STEP_MS               (STEP_TICKS * (uint32_t) TICK_US / 1000)
+
+uint16_t next_step = 0;               // tick the next step is due
+uint16_t last_frame = 0;
+uint16_t frame_ticks = STEP_TICKS;    // length of the last frame
+uint16_t busy_ticks = 0;              // the same, without the wait
+uint32_t gameTime = 0;                // ms. Moves STEP_MS per step, so replays match
+
+#ifndef HOST
+volatile uint16_t sched_ticks = 0;
+
+ISR(TIMER0_COMPB_vect) {
+  sched_ticks++;
+}
+
+uint16_t ticks() {
+  uint16_t t;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    t = sched_ticks;
+  }
+  return t;
+}
+
+void scheduler_init() {
+  OCR0B = 0x80;                       // Half way of the overflow, away from the millis() interrupt
+  TIMSK0 |= _BV(OCIE0B);
+  set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+// Sleep until the next step is due. Interrupts are disabled between the check
+// and the sleep, so a tick can't slip in between (sei lets one more
+// instruction run before any interrupt)
+void waitStep() {
+  cli();
+  while ((int16_t) (sched_ticks - next_step) < 0) {
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+  sei();
+}
+#else
+uint16_t ticks() {
+  return millis();
+}
+
+void scheduler_init() {}
+
+void waitStep() {
+  while ((int16_t) (ticks() - next_step) < 0);
+}
+#endif
+
+// The next frame starts now. For the start of a game
+void scheduler_reset() {
+  next_step = last_frame = ticks();
+  frame_ticks = STEP_TICKS;
+}
+
+// Waits until a step is due. Returns the steps to simulate in this frame. If
+// the game is behind by more than MAX_STEPS, the rest are dropped and
+// the game slows down
+uint8_t waitFrame() {
+  busy_ticks = ticks() - last_frame;
+  waitStep();
+
+  uint16_t now = ticks();
+  uint8_t steps = 0;
+  while ((int16_t) (now - next_step) >= 0 && steps < MAX_STEPS) {
+    next_step += STEP_TICKS;
+    steps++;
+  }
+  if ((int16_t) (now - next_step) >= 0) {
+    next_step = now + STEP_TICKS;
+  }
+
+  frame_ticks = now - last_frame;
+  last_frame = now;
+  return steps;
+}
+
+// Ticks left before the next step is due. Negative when the game is late
+int16_t frameBudget() {
+  return next_step - ticks();
+}
+
+uint16_t getActualFps() {
+  return 1000000UL / ((uint32_t) TICK_US * max(frame_ticks, 1));
+}
+
+#endif
@@ -10,7 +10,7 @@
 #ifndef _sound_h
 #define _sound_h
 
-#include <avr/pgmspace.h>
+#include "hal.h"
 #include "constants.h"
 
 constexpr uint8_t GET_KEY_SND_LEN = 90;
@@ -26,11 +26,37 @@ constexpr uint8_t walk2_snd[] PROGMEM = { 0x84, 0x87, 0x84};
 constexpr uint8_t MEDKIT_SND_LEN = 69;
 constexpr uint8_t medkit_snd[] PROGMEM = {0x55 , 0x20 , 0x3a , 0x3a , 0x3a , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x33 , 0x33 , 0x33 , 0x33 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x26 , 0x26 , 0x26 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x16 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x20 , 0x15 , 0x15 , 0x15 , 0x15 , 0x15 , 0x15, 0x15};
 
+void sound_init();
+void setFrequency(uint16_t freq);
+void off();
+
 uint8_t idx = 0;
 bool sound = false;
-uint16_t snd_ptr = 0;
+const uint8_t *snd_ptr = 0;
 uint8_t snd_len = 0;
 
+void playSound(const uint8_t* snd, uint8_t len) {
+  snd_ptr = snd;
+  snd_len = len;
+  sound = true;
+}
+
+// Steps the playing sound. Called at ~140Hz
+void soundTick() {
+  if (sound) {
+    if (idx < snd_len) {
+      uint16_t freq = 1192030 / (60 * (uint16_t) pgm_read_byte(snd_ptr + idx++)); // 1193181
+      setFrequency(freq);
+    } else {
+      idx = 0;
+      off();
+      sound = false;
+    }
+  }
+}
+
+// Sound output. The host build provides its own (host/host.cpp)
+#ifndef HOST
 void sound_init() {
   pinMode(SOUND_PIN, OUTPUT);
 
@@ -40,12 +66,6 @@ void sound_init() {
   TIMSK2 = (1 << OCIE2A);
 }
 
-void playSound(const uint8_t* snd, uint8_t len) {
-  snd_ptr = reinterpret_cast<uint16_t>(snd);
-  snd_len = len;
-  sound = true;
-}
-
 // Set the frequency that we will get on pin OCR1A
 void setFrequency(uint16_t freq) {
   uint32_t requiredDivisor = (F_CPU / 2) / (uint32_t)freq;
@@ -81,16 +101,8 @@ void off() {
 }
 
 ISR(TIMER2_COMPA_vect) {
-  if (sound) {
-    if (idx++ < snd_len) {
-      uint16_t freq = 1192030 / (60 * (uint16_t) pgm_read_byte(snd_ptr + idx)); // 1193181
-      setFrequency(freq);
-    } else {
-      idx = 0;
-      off();
-      sound = false;
-    }
-  }
+  soundTick();
 }
+#endif
 
 #endif
@@ -0,0 +1,352 @@
+#ifndef _sprite_mips_h
+#define _sprite_mips_h
+
+#include "hal.h"
+#include "sprites.h"
+
+/*
+  Generated by tools/gen_sprite_mips.py. Do not edit.
+
+  Each sprite has several levels, from the full size one in sprites.h down
+  to the smallest. drawSprite() picks the smallest level that still covers
+  the on screen size.
+*/
+struct SpriteMip {
+  const uint8_t *bitmap;
+  const uint8_t *mask;
+  uint8_t width;
+  uint8_t height;
+};
+
+const static uint8_t bmp_imp_bits_16[] PROGMEM = {
+  0x00, 0x00,
+  0x01, 0x80,
+  0x03, 0x80,
+  0x01, 0x40,
+  0x0c, 0xb0,
+  0x02, 0x40,
+  0x00, 0x10,
+  0x10, 0x00,
+  0x00, 0x08,
+  0x02, 0x40,
+  0x02, 0x40,
+  0x00, 0x00,
+  0x02, 0x00,
+  0x00, 0x00,
+  0x01, 0x00,
+  0x03, 0x00,
+  0x01, 0x80,
+  0x01, 0x80,
+  0x02, 0x00,
+  0x0d, 0x10,
+  0x02, 0x60,
+  0x00, 0x10,
+  0x00, 0x08,
+  0x08, 0x00,
+  0x02, 0x00,
+  0x01, 0x40,
+  0x00, 0x80,
+  0x01, 0x00,
+  0x02, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x20,
+  0x01, 0x70,
+  0x01, 0xb4,
+  0x01, 0x68,
+  0x01, 0x00,
+  0x02, 0x40,
+  0x00, 0x04,
+  0x00, 0x00,
+  0x01, 0x00,
+  0x00, 0x60,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x40,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x10,
+  0x00, 0x08,
+  0x01, 0xf8,
+  0x02, 0xc8,
+  0x03, 0x40,
+  0x01, 0x20,
+  0x06, 0x30,
+  0x04, 0x10,
+  0x0c, 0x10,
+  0x00, 0x20,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x20,
+  0x01, 0x20,
+  0x05, 0xd8,
+  0x1e, 0x00,
+  0x31, 0x13,
+  0x00, 0x00,
+  0x00, 0x00,
+};
+
+const static uint8_t bmp_imp_mask_16[] PROGMEM = {
+  0x00, 0x00,
+  0x01, 0x80,
+  0x03, 0xc0,
+  0x01, 0xc0,
+  0x0f, 0xf0,
+  0x0f, 0xf0,
+  0x0f, 0xf8,
+  0x1b, 0xd8,
+  0x13, 0xd8,
+  0x13, 0xf8,
+  0x17, 0xe0,
+  0x03, 0xe0,
+  0x03, 0x40,
+  0x03, 0x40,
+  0x01, 0x40,
+  0x03, 0x00,
+  0x01, 0x80,
+  0x03, 0x80,
+  0x03, 0x80,
+  0x0f, 0xf0,
+  0x07, 0xf0,
+  0x0f, 0xf0,
+  0x1b, 0xd8,
+  0x1b, 0xd8,
+  0x0b, 0xd0,
+  0x03, 0xe0,
+  0x03, 0xc0,
+  0x03, 0xc0,
+  0x03, 0x40,
+  0x01, 0x40,
+  0x03, 0x40,
+  0x00, 0x40,
+  0x00, 0x00,
+  0x00, 0x30,
+  0x01, 0x70,
+  0x01, 0xf4,
+  0x01, 0xf8,
+  0x01, 0xf8,
+  0x03, 0xf8,
+  0x00, 0xec,
+  0x01, 0xe4,
+  0x01, 0xe4,
+  0x03, 0xe0,
+  0x03, 0x60,
+  0x01, 0xe0,
+  0x01, 0xe0,
+  0x00, 0x60,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x70,
+  0x00, 0x78,
+  0x01, 0xf8,
+  0x03, 0xf8,
+  0x03, 0xf0,
+  0x01, 0xe0,
+  0x07, 0xf0,
+  0x06, 0x30,
+  0x0e, 0x30,
+  0x06, 0x38,
+  0x04, 0x10,
+  0x1c, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x00,
+  0x00, 0x20,
+  0x01, 0xf0,
+  0x07, 0xf8,
+  0x1f, 0xf8,
+  0x7f, 0xff,
+  0x78, 0x1c,
+  0x20, 0x00,
+};
+
+const static uint8_t bmp_imp_bits_8[] PROGMEM = {
+  0x00,
+  0x18,
+  0x2c,
+  0x00,
+  0x02,
+  0x00,
+  0x00,
+  0x10,
+  0x18,
+  0x34,
+  0x04,
+  0x22,
+  0x10,
+  0x00,
+  0x00,
+  0x00,
+  0x04,
+  0x1c,
+  0x12,
+  0x10,
+  0x10,
+  0x04,
+  0x00,
+  0x00,
+  0x00,
+  0x04,
+  0x0e,
+  0x18,
+  0x14,
+  0x24,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x1c,
+  0x71,
+  0x00,
+};
+
+const static uint8_t bmp_imp_mask_8[] PROGMEM = {
+  0x00,
+  0x18,
+  0x3c,
+  0x3e,
+  0x5e,
+  0x1c,
+  0x18,
+  0x10,
+  0x18,
+  0x3c,
+  0x3c,
+  0x7e,
+  0x1c,
+  0x18,
+  0x18,
+  0x18,
+  0x04,
+  0x1c,
+  0x1e,
+  0x1e,
+  0x1e,
+  0x1c,
+  0x1c,
+  0x00,
+  0x00,
+  0x04,
+  0x0e,
+  0x1c,
+  0x1c,
+  0x34,
+  0x24,
+  0x20,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x00,
+  0x1c,
+  0x7f,
+  0x42,
+};
+
+#define BMP_IMP_MIPS        3
+const static SpriteMip bmp_imp_mips[] PROGMEM = {
+  { bmp_imp_bits, bmp_imp_mask, 32, 32 },
+  { bmp_imp_bits_16, bmp_imp_mask_16, 16, 16 },
+  { bmp_imp_bits_8, bmp_imp_mask_8, 8, 8 }
+};
+
+const static uint8_t bmp_fireball_bits_8[] PROGMEM = {
+  0x00,
+  0x3c,
+  0x9e,
+  0x3e,
+  0x7c,
+  0x1f,
+  0x00,
+  0x00,
+};
+
+const static uint8_t bmp_fireball_mask_8[] PROGMEM = {
+  0x3c,
+  0x7e,
+  0xfe,
+  0xff,
+  0xff,
+  0xff,
+  0x7e,
+  0x1c,
+};
+
+#define BMP_FIREBALL_MIPS   2
+const static SpriteMip bmp_fireball_mips[] PROGMEM = {
+  { bmp_fireball_bits, bmp_fireball_mask, 16, 16 },
+  { bmp_fireball_bits_8, bmp_fireball_mask_8, 8, 8 }
+};
+
+const static uint8_t bmp_items_bits_8[] PROGMEM = {
+  0x7e,
+  0xff,
+  0xff,
+  0xff,
+  0xff,
+  0xe7,
+  0xe7,
+  0x7e,
+  0x00,
+  0x00,
+  0x3e,
+  0x5e,
+  0x7e,
+  0x7e,
+  0x1e,
+  0x00,
+};
+
+const static uint8_t bmp_items_mask_8[] PROGMEM = {
+  0x7e,
+  0xff,
+  0xff,
+  0xff,
+  0xff,
+  0xff,
+  0xff,
+  0x7e,
+  0x00,
+  0x00,
+  0x3e,
+  0x7e,
+  0x7e,
+  0x7e,
+  0x1e,
+  0x00,
+};
+
+#define BMP_ITEMS_MIPS      2
+const static SpriteMip bmp_items_mips[] PROGMEM = {
+  { bmp_items_bits, bmp_items_mask, 16, 16 },
+  { bmp_items_bits_8, bmp_items_mask_8, 8, 8 }
+};
+
+#endif
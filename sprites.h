@@ -1,7 +1,7 @@
 #ifndef _sprites_h
 #define _sprites_h
 
-#include <avr/pgmspace.h>
+#include "hal.h"
 #include <stdint.h>
 
 #define bmp_font_width   24  // in bytes
@@ -716,5 +716,20 @@ const static uint8_t gradient[] PROGMEM = {
   0xff, 0xff,
 };
 
+// Same gradients transposed to SSD1306 page bytes. One vertical byte per
+// gradient and x % GRADIENT_COLUMNS, valid for any page.
+// Generated by tools/gen_gradient_columns.py
+#define GRADIENT_COLUMNS 16
+const static uint8_t gradient_columns[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0xa8, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0xa8, 0x00,
+  0xaa, 0x00, 0xaa, 0x04, 0xaa, 0x00, 0xaa, 0x40, 0xaa, 0x00, 0xaa, 0x04, 0xaa, 0x00, 0xaa, 0x40,
+  0xaa, 0x15, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44, 0xaa, 0x55, 0xaa, 0x44,
+  0xaa, 0x55, 0xaa, 0xdd, 0xaa, 0x55, 0xaa, 0xdd, 0xaa, 0x75, 0xaa, 0xdd, 0xaa, 0x55, 0xaa, 0xdd,
+  0xaa, 0x7f, 0xaa, 0xff, 0xaa, 0x77, 0xaa, 0xff, 0xaa, 0x7f, 0xaa, 0xff, 0xaa, 0xf7, 0xaa, 0xff,
+  0xee, 0xff, 0xba, 0xff, 0xee, 0xff, 0xbb, 0xff, 0xee, 0xff, 0xba, 0xff, 0xee, 0xff, 0xab, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
 #endif
 
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Generates camera.h: per heading / per column ray tables for the raycaster.
+
+Only one quadrant of headings is stored. The other three and the y component
+are obtained by symmetry (see camera.h).
+
+There is a column per ray, SCREEN_WIDTH / RES_DIVIDER, read from constants.h.
+Run it again when those change: camera.h doesn't build against other values.
+
+Usage: python3 tools/gen_camera.py < constants.h > camera.h
+"""
+import math
+import re
+import sys
+
+HEADINGS = 64           # Must match CAMERA_HEADINGS
+PLANE = 0.66            # Length of the camera plane (field of view)
+FX_ONE = 1 << 8         # Q8.8
+FX_DIR_ONE = 1 << 12    # Q4.12
+MAX_RECIP = 0x7FFF
+
+src = sys.stdin.read()
+SCREEN_WIDTH = int(re.search(r'\bSCREEN_WIDTH\s*=\s*(\d+)', src).group(1))
+RES_DIVIDER = int(re.search(r'#define RES_DIVIDER\s+(\d+)', src).group(1))
+COLUMNS = SCREEN_WIDTH // RES_DIVIDER
+
+quarter = HEADINGS // 4
+
+
+def ray_x(a, k):
+    theta = 2 * math.pi * a / HEADINGS
+    cam = 2 * k / COLUMNS - 1
+    return math.cos(theta) + PLANE * cam * math.sin(theta)
+
+
+def recip(v):
+    if abs(v) * MAX_RECIP < FX_ONE:
+        return MAX_RECIP if v >= 0 else -MAX_RECIP
+    return int(round(FX_ONE / v))
+
+
+def rows(values, per_row=16):
+    out = []
+    for i in range(0, len(values), per_row):
+        out.append('  ' + ', '.join(str(v) for v in values[i:i + per_row]) + ',')
+    return '\n'.join(out)
+
+
+sin_table = [int(round(math.sin(2 * math.pi * a / HEADINGS) * FX_DIR_ONE)) for a in range(quarter + 1)]
+recip_table = [recip(ray_x(a, k)) for a in range(quarter + 1) for k in range(COLUMNS + 1)]
+
+print('''#ifndef _camera_h
+#define _camera_h
+
+#include "hal.h"
+#include "constants.h"
+#include "fixed.h"
+
+/*
+  Generated by tools/gen_camera.py. Do not edit.
+
+  The player heading is a quantized angle (1/256 turns). The camera uses
+  CAMERA_HEADINGS steps of it, so each one has precomputed ray reciprocals.
+
+  For a heading a in the first quadrant and camera column k (camera_x = 2k / COLUMNS - 1):
+    ray_x(a, k) = cos(a) + PLANE * camera_x * sin(a)
+    ray_y(a, k) = ray_x(QUARTER - a, COLUMNS - k)
+  Other quadrants rotate those by 90 degrees.
+*/
+#define CAMERA_HEADINGS     %d
+#define CAMERA_QUARTER      %d
+#define CAMERA_COLUMNS      %d          // SCREEN_WIDTH / RES_DIVIDER
+#define CAMERA_ANGLE_SHIFT  2           // 256 angle units / CAMERA_HEADINGS
+#define CAMERA_PLANE        %s        // Camera plane length (field of view)
+#define CAMERA_PLANE_DIR    %d        // The same, Q4.12
+
+static_assert(CAMERA_COLUMNS == SCREEN_WIDTH / RES_DIVIDER, "camera.h is stale: python3 tools/gen_camera.py < constants.h > camera.h");
+
+// sin() of the first quadrant headings, Q4.12
+const static int16_t PROGMEM camera_sin[CAMERA_QUARTER + 1] = {
+%s
+};
+
+// 1 / ray_x of the first quadrant headings, Q8.8 signed, saturated to 0x7FFF
+const static int16_t PROGMEM camera_ray_recip[(CAMERA_QUARTER + 1) * (CAMERA_COLUMNS + 1)] = {
+%s
+};
+
+// sin() of a heading (0..CAMERA_HEADINGS - 1), Q4.12
+inline int16_t camera_heading_sin(uint8_t heading) {
+  uint8_t a = heading & (CAMERA_QUARTER - 1);
+  uint8_t quad = (heading / CAMERA_QUARTER) & 0b11;
+  int16_t s = pgm_read_word(camera_sin + (quad & 1 ? CAMERA_QUARTER - a : a));
+  return quad & 0b10 ? -s : s;
+}
+
+inline int16_t camera_heading_cos(uint8_t heading) {
+  return camera_heading_sin(heading + CAMERA_QUARTER);
+}
+
+// 1 / ray of the camera column k (0..CAMERA_COLUMNS) for a heading, Q8.8 signed
+inline void camera_ray_recip_at(uint8_t heading, uint8_t k, int16_t *recip_x, int16_t *recip_y) {
+  uint8_t a = heading & (CAMERA_QUARTER - 1);
+  int16_t x = pgm_read_word(camera_ray_recip + a * (CAMERA_COLUMNS + 1) + k);
+  int16_t y = pgm_read_word(camera_ray_recip + (CAMERA_QUARTER - a) * (CAMERA_COLUMNS + 1) + CAMERA_COLUMNS - k);
+
+  // rotate by 90 degrees steps
+  switch ((heading / CAMERA_QUARTER) & 0b11) {
+    case 0: *recip_x = x;  *recip_y = y;  break;
+    case 1: *recip_x = -y; *recip_y = x;  break;
+    case 2: *recip_x = -x; *recip_y = -y; break;
+    case 3: *recip_x = y;  *recip_y = -x; break;
+  }
+}
+
+#endif''' % (HEADINGS, quarter, COLUMNS, PLANE, round(PLANE * 4096), rows(sin_table), rows(recip_table, COLUMNS + 1 if COLUMNS + 1 <= 17 else 13)))
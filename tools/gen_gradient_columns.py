@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+"""
+Transposes the `gradient` dither patterns from sprites.h into SSD1306 page
+bytes: one vertical byte per (gradient, x % 16). Since the patterns are
+8 rows high, the same byte is valid for every page of the column.
+
+Usage: python3 tools/gen_gradient_columns.py < sprites.h
+"""
+import re
+import sys
+
+GRADIENT_WIDTH = 2
+GRADIENT_HEIGHT = 8
+
+src = sys.stdin.read()
+body = re.search(r'gradient\[\] PROGMEM = \{(.*?)\};', src, re.S).group(1)
+data = [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+count = len(data) // (GRADIENT_WIDTH * GRADIENT_HEIGHT)
+columns = GRADIENT_WIDTH * 8
+
+for i in range(count):
+    row = []
+    for x in range(columns):
+        b = 0
+        for y in range(GRADIENT_HEIGHT):
+            byte = data[i * GRADIENT_WIDTH * GRADIENT_HEIGHT + y * GRADIENT_WIDTH + x // 8]
+            if byte & (0x80 >> (x % 8)):
+                b |= 1 << y
+        row.append('0x%02x' % b)
+    print('  ' + ', '.join(row) + ',')
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Generates level_distance.h: per cell of each level, the Chebyshev distance
+to the nearest wall, up to 3, in 2 bits. 0 on the walls. The corridors of
+E1M1 are 3 cells wide, so longer distances wouldn't pay their bits.
+
+Packed 4 cells per byte, rows from the top like the level, the lowest x in
+the highest bits.
+
+Usage: python3 tools/gen_level_distance.py < level.h > level_distance.h
+"""
+import re
+import sys
+
+LEVEL_WIDTH = 64        # Must match LEVEL_WIDTH
+LEVEL_HEIGHT = 57       # Must match LEVEL_HEIGHT
+MAX_DISTANCE = 3
+
+E_WALL = 0xF
+
+src = sys.stdin.read()
+
+
+def distance_field(cells):
+    # Two passes of a chamfer transform with unit diagonals give the
+    # exact Chebyshev distance
+    far = MAX_DISTANCE
+    d = [[0 if cells[r][x] == E_WALL else far for x in range(LEVEL_WIDTH)] for r in range(LEVEL_HEIGHT)]
+    for r in range(LEVEL_HEIGHT):
+        for x in range(LEVEL_WIDTH):
+            for dr, dx in ((-1, -1), (-1, 0), (-1, 1), (0, -1)):
+                if 0 <= r + dr < LEVEL_HEIGHT and 0 <= x + dx < LEVEL_WIDTH:
+                    d[r][x] = min(d[r][x], d[r + dr][x + dx] + 1)
+    for r in reversed(range(LEVEL_HEIGHT)):
+        for x in reversed(range(LEVEL_WIDTH)):
+            for dr, dx in ((1, 1), (1, 0), (1, -1), (0, 1)):
+                if 0 <= r + dr < LEVEL_HEIGHT and 0 <= x + dx < LEVEL_WIDTH:
+                    d[r][x] = min(d[r][x], d[r + dr][x + dx] + 1)
+    return d
+
+
+print('#ifndef _level_distance_h')
+print('#define _level_distance_h')
+print()
+print('#include "hal.h"')
+print('#include "level.h"')
+print()
+print('/*')
+print('  Generated by tools/gen_level_distance.py. Do not edit.')
+print()
+print('  Distance fields of the levels (see getDistanceAt()). The raycaster')
+print('  walks them instead of the levels. Its rays cross the cells within the')
+print('  distance of the last one read without reading them.')
+print('*/')
+print()
+print('#define LEVEL_DISTANCE_SIZE (LEVEL_WIDTH / 4 * LEVEL_HEIGHT)')
+
+for name, body in re.findall(r'\b(sto_level_\w+)\[LEVEL_SIZE\] PROGMEM = \{(.*?)\};', src, re.S):
+    data = [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+    cells = [[data[(r * LEVEL_WIDTH + x) // 2] >> (0 if x % 2 else 4) & 0xF for x in range(LEVEL_WIDTH)]
+             for r in range(LEVEL_HEIGHT)]
+    d = distance_field(cells)
+
+    print()
+    print('const static uint8_t %s_distance[LEVEL_DISTANCE_SIZE] PROGMEM = {' % name)
+    for r in range(LEVEL_HEIGHT):
+        row = ['0x%02X' % (d[r][x] << 6 | d[r][x + 1] << 4 | d[r][x + 2] << 2 | d[r][x + 3])
+               for x in range(0, LEVEL_WIDTH, 4)]
+        print('  ' + ', '.join(row) + ',')
+    print('};')
+
+print()
+print('#endif')
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Generates level_entities.h: the enemies and items of each level, bucketed
+by map region, for spawnEntities().
+
+The map is split in squares of 8x8 cells. The entities are listed bucket by
+bucket (rows of buckets from y 0 up, x 0 right), and the buckets table has
+the index of the first entity of each bucket, plus the end of the list. An
+entity's index in the list (its ordinal) stays the same, so it identifies
+it (see world.h).
+
+Usage: python3 tools/gen_level_entities.py < level.h > level_entities.h
+"""
+import re
+import sys
+
+LEVEL_WIDTH = 64        # Must match LEVEL_WIDTH
+LEVEL_HEIGHT = 57       # Must match LEVEL_HEIGHT
+BUCKET_SHIFT = 3
+
+E_WALL = 0xF
+E_ENEMY = 0x2
+NAMES = {0x2: 'E_ENEMY', 0x8: 'E_MEDIKIT', 0x9: 'E_KEY'}
+
+BUCKETS_X = LEVEL_WIDTH >> BUCKET_SHIFT
+BUCKETS_Y = (LEVEL_HEIGHT + (1 << BUCKET_SHIFT) - 1) >> BUCKET_SHIFT
+
+src = sys.stdin.read()
+
+print('#ifndef _level_entities_h')
+print('#define _level_entities_h')
+print()
+print('#include "hal.h"')
+print('#include "level.h"')
+print('#include "types.h"')
+print()
+print('/*')
+print('  Generated by tools/gen_level_entities.py. Do not edit.')
+print()
+print('  Enemies and items of the levels, by region of ENTITY_BUCKET_SIZE')
+print('  cells (see spawnEntities()). Coords are cells, in level coords.')
+print('*/')
+print()
+print('#define ENTITY_BUCKET_SHIFT %d' % BUCKET_SHIFT)
+print('#define ENTITY_BUCKET_SIZE  (1 << ENTITY_BUCKET_SHIFT)')
+print('#define ENTITY_BUCKETS_X    %d' % BUCKETS_X)
+print('#define ENTITY_BUCKETS_Y    %d' % BUCKETS_Y)
+print()
+levels = []
+for name, body in re.findall(r'\b(sto_level_\w+)\[LEVEL_SIZE\] PROGMEM = \{(.*?)\};', src, re.S):
+    data = [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+    buckets = [[] for _ in range(BUCKETS_X * BUCKETS_Y)]
+    for y in range(LEVEL_HEIGHT):
+        for x in range(LEVEL_WIDTH):
+            r = LEVEL_HEIGHT - 1 - y
+            block = data[(r * LEVEL_WIDTH + x) // 2] >> (0 if x % 2 else 4) & 0xF
+            # Same test the raycaster used to spawn them
+            if block != E_WALL and (block == E_ENEMY or block & 0b1000):
+                b = (y >> BUCKET_SHIFT) * BUCKETS_X + (x >> BUCKET_SHIFT)
+                buckets[b].append((x, y, block))
+
+    entities = [e for bucket in buckets for e in bucket]
+    if len(entities) > 254:
+        sys.exit('%s: too many entities' % name)
+    levels.append((name, buckets, entities))
+
+print('#define MAX_LEVEL_ENTITIES  %d    // Of the level with the most' % max(len(e) for _, _, e in levels))
+print()
+print('struct LevelEntity {')
+print('  uint8_t x;')
+print('  uint8_t y;')
+print('  uint8_t type;')
+print('};')
+
+for name, buckets, entities in levels:
+    print()
+    print('const static LevelEntity %s_entities[] PROGMEM = {' % name)
+    for x, y, block in entities:
+        print('  { %2d, %2d, %s },' % (x, y, NAMES[block]))
+    print('};')
+    print()
+    print('const static uint8_t %s_buckets[ENTITY_BUCKETS_X * ENTITY_BUCKETS_Y + 1] PROGMEM = {' % name)
+    first = 0
+    for by in range(BUCKETS_Y):
+        row = []
+        for bx in range(BUCKETS_X):
+            row.append('%2d' % first)
+            first += len(buckets[by * BUCKETS_X + bx])
+        print('  ' + ', '.join(row) + ',')
+    print('  %2d' % first)
+    print('};')
+
+print()
+print('#endif')
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+Generates level_walls.h: the walls of each level, 1 bit per cell, for
+isWall().
+
+A row is LEVEL_WIDTH / 8 = 8 bytes, the lowest x in the highest bit. Rows
+go by y, bottom up, so y indexes them straight (the rows of the levels are
+stored top down).
+
+Usage: python3 tools/gen_level_walls.py < level.h > level_walls.h
+"""
+import re
+import sys
+
+LEVEL_WIDTH = 64        # Must match LEVEL_WIDTH
+LEVEL_HEIGHT = 57       # Must match LEVEL_HEIGHT
+
+E_WALL = 0xF
+
+src = sys.stdin.read()
+
+print('#ifndef _level_walls_h')
+print('#define _level_walls_h')
+print()
+print('#include "hal.h"')
+print('#include "level.h"')
+print()
+print('/*')
+print('  Generated by tools/gen_level_walls.py. Do not edit.')
+print()
+print('  Wall bitmaps of the levels (see isWall()). The levels keep the rest')
+print('  of the blocks.')
+print('*/')
+print()
+print('#define LEVEL_WALLS_SIZE    (LEVEL_WIDTH / 8 * LEVEL_HEIGHT)')
+
+for name, body in re.findall(r'\b(sto_level_\w+)\[LEVEL_SIZE\] PROGMEM = \{(.*?)\};', src, re.S):
+    data = [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+    cells = [[data[(r * LEVEL_WIDTH + x) // 2] >> (0 if x % 2 else 4) & 0xF for x in range(LEVEL_WIDTH)]
+             for r in range(LEVEL_HEIGHT)]
+
+    print()
+    print('const static uint8_t %s_walls[LEVEL_WALLS_SIZE] PROGMEM = {' % name)
+    for y in range(LEVEL_HEIGHT):
+        row = cells[LEVEL_HEIGHT - 1 - y]
+        out = []
+        for bx in range(0, LEVEL_WIDTH, 8):
+            b = 0
+            for x in range(bx, bx + 8):
+                b = b << 1 | (row[x] == E_WALL)
+            out.append('0x%02X' % b)
+        print('  ' + ', '.join(out) + ',')
+    print('};')
+
+print()
+print('#endif')
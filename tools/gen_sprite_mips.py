@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Generates sprite_mips.h: pre-downscaled levels (half size each) of the
+sprites rendered by the raycaster, with their masks.
+
+A level pixel is visible when at least 2 of the 4 source pixels are, and
+white when most of the visible source pixels are white.
+
+Usage: python3 tools/gen_sprite_mips.py < sprites.h > sprite_mips.h
+"""
+import re
+import sys
+
+# name, width, height, frames, smallest level width
+SPRITES = [
+    ('imp', 32, 32, 5, 8),
+    ('fireball', 16, 16, 1, 8),
+    ('items', 16, 16, 2, 8),
+]
+
+src = sys.stdin.read()
+
+
+def read_array(name):
+    body = re.search(r'\b%s\[\] PROGMEM = \{(.*?)\};' % name, src, re.S).group(1)
+    return [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+
+
+def unpack(data, w, h, frames):
+    bw = w // 8
+    return [[[bool(data[f * bw * h + y * bw + x // 8] & (0x80 >> (x % 8))) for x in range(w)]
+             for y in range(h)] for f in range(frames)]
+
+
+def pack(pixels):
+    out = []
+    for frame in pixels:
+        for row in frame:
+            for bx in range(0, len(row), 8):
+                b = 0
+                for i, p in enumerate(row[bx:bx + 8]):
+                    if p:
+                        b |= 0x80 >> i
+                out.append(b)
+    return out
+
+
+def downscale(bits, mask):
+    new_bits, new_mask = [], []
+    for fb, fm in zip(bits, mask):
+        h, w = len(fb) // 2, len(fb[0]) // 2
+        b_rows, m_rows = [], []
+        for y in range(h):
+            b_row, m_row = [], []
+            for x in range(w):
+                cells = [(2 * y + dy, 2 * x + dx) for dy in (0, 1) for dx in (0, 1)]
+                visible = [c for c in cells if fm[c[0]][c[1]]]
+                white = [c for c in visible if fb[c[0]][c[1]]]
+                m_row.append(len(visible) >= 2)
+                b_row.append(len(visible) >= 2 and 2 * len(white) >= len(visible))
+            b_rows.append(b_row)
+            m_rows.append(m_row)
+        new_bits.append(b_rows)
+        new_mask.append(m_rows)
+    return new_bits, new_mask
+
+
+def rows(values, per_row):
+    return '\n'.join('  ' + ', '.join('0x%02x' % v for v in values[i:i + per_row]) + ','
+                     for i in range(0, len(values), per_row))
+
+
+print('''#ifndef _sprite_mips_h
+#define _sprite_mips_h
+
+#include "hal.h"
+#include "sprites.h"
+
+/*
+  Generated by tools/gen_sprite_mips.py. Do not edit.
+
+  Each sprite has several levels, from the full size one in sprites.h down
+  to the smallest. drawSprite() picks the smallest level that still covers
+  the on screen size.
+*/
+struct SpriteMip {
+  const uint8_t *bitmap;
+  const uint8_t *mask;
+  uint8_t width;
+  uint8_t height;
+};
+''')
+
+for name, w, h, frames, min_w in SPRITES:
+    bits = unpack(read_array('bmp_%s_bits' % name), w, h, frames)
+    mask = unpack(read_array('bmp_%s_mask' % name), w, h, frames)
+    levels = ['{ bmp_%s_bits, bmp_%s_mask, %d, %d }' % (name, name, w, h)]
+    lw, lh = w, h
+    while lw > min_w:
+        bits, mask = downscale(bits, mask)
+        lw, lh = lw // 2, lh // 2
+        print('const static uint8_t bmp_%s_bits_%d[] PROGMEM = {\n%s\n};\n' % (name, lw, rows(pack(bits), lw // 8)))
+        print('const static uint8_t bmp_%s_mask_%d[] PROGMEM = {\n%s\n};\n' % (name, lw, rows(pack(mask), lw // 8)))
+        levels.append('{ bmp_%s_bits_%d, bmp_%s_mask_%d, %d, %d }' % (name, lw, name, lw, lw, lh))
+
+    print('#define BMP_%s_MIPS %s%d' % (name.upper(), ' ' * (10 - len(name)), len(levels)))
+    print('const static SpriteMip bmp_%s_mips[] PROGMEM = {\n%s\n};\n' % (name, ',\n'.join('  ' + l for l in levels)))
+
+print('#endif')
@@ -1,19 +1,24 @@
 #include <stdint.h>
-#include <math.h>
+#include <stdlib.h>
 #include "types.h"
 #include "constants.h"
 
-template <class T>
-inline T sq(T value) {
-    return value * value;
-}
-
-Coords create_coords(double x, double y) {
-  return { x, y };
-}
+// Q8.8 offset past which the distance is over 255 for sure. Long math: the
+// product doesn't fit the 16 bit int of the AVR
+constexpr int16_t COORDS_FAR = 256L * FX_ONE / DISTANCE_MULTIPLIER;
+static_assert(COORDS_FAR > 0 && 256L * FX_ONE / DISTANCE_MULTIPLIER <= 0x7FFF, "COORDS_FAR must fit int16_t");
+static_assert((long) LEVEL_WIDTH * FX_ONE <= 0x7FFF && (long) LEVEL_HEIGHT * FX_ONE <= 0x7FFF, "Coords must fit int16_t");
 
+// In 1 / DISTANCE_MULTIPLIER cells, saturated to 255
 uint8_t coords_distance(Coords* a, Coords* b) {
-  return sqrt(sq(a->x - b->x) + sq(a->y - b->y)) * DISTANCE_MULTIPLIER;
+  int16_t dx = abs(a->x - b->x);
+  int16_t dy = abs(a->y - b->y);
+
+  // Keeps the squares inside 32 bits
+  if (dx >= COORDS_FAR || dy >= COORDS_FAR) return 255;
+
+  uint16_t distance = (uint32_t) fx_sqrt((int32_t) dx * dx + (int32_t) dy * dy) * DISTANCE_MULTIPLIER >> FX_SHIFT;
+  return distance > 255 ? 255 : distance;
 }
 
 UID create_uid(uint8_t type, uint8_t x, uint8_t y) {
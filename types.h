@@ -1,6 +1,8 @@
 #ifndef _types_h
 #define _types_h
 
+#include "fixed.h"
+
 #define UID_null  0
 
 // Entity types (legend applies to level.h)
@@ -19,7 +21,17 @@
 typedef uint16_t UID;
 typedef uint8_t  EType;
 
+// Q8.8 (see fixed.h). Cells, for the positions
 struct Coords {
+  int16_t x;
+  int16_t y;
+};
+
+#define coords_center(cell)   ((int16_t) ((cell) * FX_ONE + FX_ONE / 2))
+#define coords_cell(v)        ((uint8_t) ((v) >> FX_SHIFT))
+
+// Camera space, for the sprites. y is the depth
+struct ViewCoords {
   double x;
   double y;
 };
@@ -27,7 +39,6 @@ struct Coords {
 UID create_uid(EType type, uint8_t x, uint8_t y);
 EType uid_get_type(UID uid);
 
-Coords create_coords(double x, double y);
 uint8_t coords_distance(Coords* a, Coords* b);
 
 #endif
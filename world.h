@@ -0,0 +1,84 @@
+#ifndef _world_h
+#define _world_h
+
+/*
+  What changed in the level since it started, so the entities don't come
+  back when they're spawned again (see spawnEntities()):
+  - A bit per entity of the level, by its ordinal (level_entities.h). Set
+    when an enemy dies or an item is picked up. Those aren't spawned again.
+  - The cell and health of up to MAX_SAVED_ENEMIES enemies dozed alive
+    (too far from the player). They come back there, and free the slot.
+    When the slots run out one is reused, and that enemy comes back to its
+    place in the level, healed. They're still looked up by their place in
+    the level, so they come back when the player is near both.
+
+  4 bytes for the bits of E1M1, and 4 per saved enemy.
+*/
+#include "hal.h"
+#include "constants.h"
+#include "pool.h"
+#include "level_entities.h"
+
+uint8_t world_gone_bits[(MAX_LEVEL_ENTITIES + 7) / 8];
+
+#if MAX_SAVED_ENEMIES > 0
+struct SavedEnemy {
+  uint8_t ordinal;              // NO_ORDINAL for a free slot
+  uint8_t x;
+  uint8_t y;
+  uint8_t health;
+};
+
+SavedEnemy world_saved[MAX_SAVED_ENEMIES];
+uint8_t world_next_saved = 0;
+#endif
+
+// For the start of a level
+void world_reset() {
+  memset(world_gone_bits, 0, sizeof(world_gone_bits));
+#if MAX_SAVED_ENEMIES > 0
+  for (uint8_t i = 0; i < MAX_SAVED_ENEMIES; i++) {
+    world_saved[i].ordinal = NO_ORDINAL;
+  }
+  world_next_saved = 0;
+#endif
+}
+
+bool world_gone(uint8_t ordinal) {
+  return world_gone_bits[ordinal / 8] & (1 << (ordinal % 8));
+}
+
+// The entity is dead, or picked up
+void world_remove(uint8_t ordinal) {
+  if (ordinal == NO_ORDINAL) return;
+  world_gone_bits[ordinal / 8] |= 1 << (ordinal % 8);
+}
+
+#if MAX_SAVED_ENEMIES > 0
+// The saved enemy with the ordinal, or NULL. NO_ORDINAL finds a free slot
+SavedEnemy *world_find(uint8_t ordinal) {
+  for (uint8_t i = 0; i < MAX_SAVED_ENEMIES; i++) {
+    if (world_saved[i].ordinal == ordinal) return &world_saved[i];
+  }
+  return NULL;
+}
+
+// The enemy in the slot dozes alive. Keep where it was
+void world_save(uint8_t slot) {
+  if (entity_ordinal[slot] == NO_ORDINAL) return;
+
+  SavedEnemy *saved = world_find(NO_ORDINAL);
+  if (saved == NULL) {
+    saved = &world_saved[world_next_saved];
+    world_next_saved = (world_next_saved + 1) % MAX_SAVED_ENEMIES;
+  }
+  *saved = {
+    entity_ordinal[slot],
+    coords_cell(entity_pos[slot].x),
+    coords_cell(entity_pos[slot].y),
+    entity_health[slot]
+  };
+}
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef _zbuffer_h
+#define _zbuffer_h
+
+#include <stdint.h>
+#include <string.h>
+#include "constants.h"
+#include "fixed.h"
+
+/*
+  Z buffer with compile time resolution and depth encoding.
+  Distances are passed in Q8.8. Encodings only need to keep the order of
+  distances, so values are compared without decoding them back.
+
+  Depth encodings:
+  - ZDepth8:   1 byte, linear. 1 / DISTANCE_MULTIPLIER cell steps up to 256 / DISTANCE_MULTIPLIER
+  - ZDepth12:  12 bits packed (3 bytes per 2 columns), linear. 1/256 cell steps up to 16 cells
+  - ZDepthLog: 1 byte, logarithmic (4 bit exponent, 4 bit mantissa). ~6% relative precision at any depth
+*/
+struct ZDepth8 {
+  static constexpr uint16_t bytes(uint8_t n) { return n; }
+
+  static uint16_t encode(uint16_t distance) {
+    return min((uint32_t) distance * DISTANCE_MULTIPLIER >> FX_SHIFT, 255);
+  }
+
+  static uint16_t read(const uint8_t *buf, uint8_t i) {
+    return buf[i];
+  }
+
+  static void write(uint8_t *buf, uint8_t i, uint16_t value) {
+    buf[i] = value;
+  }
+};
+
+struct ZDepth12 {
+  static constexpr uint16_t bytes(uint8_t n) { return (n * 3 + 1) / 2; }
+
+  static uint16_t encode(uint16_t distance) {
+    return min(distance, 0xFFF);
+  }
+
+  static uint16_t read(const uint8_t *buf, uint8_t i) {
+    const uint8_t *b = buf + i * 3 / 2;
+    if (i & 1) {
+      return b[0] >> 4 | (uint16_t) b[1] << 4;
+    }
+    return b[0] | (uint16_t) (b[1] & 0x0F) << 8;
+  }
+
+  static void write(uint8_t *buf, uint8_t i, uint16_t value) {
+    uint8_t *b = buf + i * 3 / 2;
+    if (i & 1) {
+      b[0] = (b[0] & 0x0F) | value << 4;
+      b[1] = value >> 4;
+    } else {
+      b[0] = value;
+      b[1] = (b[1] & 0xF0) | value >> 8;
+    }
+  }
+};
+
+struct ZDepthLog {
+  static constexpr uint16_t bytes(uint8_t n) { return n; }
+
+  static uint16_t encode(uint16_t distance) {
+    if (distance < 0x10) return distance;
+
+    // exponent: position of the leading bit. mantissa: the 4 bits under it
+    uint8_t e = 4;
+    while (distance >= 0x20) {
+      distance >>= 1;
+      e++;
+    }
+    return (e - 3) << 4 | (distance & 0x0F);
+  }
+
+  static uint16_t read(const uint8_t *buf, uint8_t i) {
+    return buf[i];
+  }
+
+  static void write(uint8_t *buf, uint8_t i, uint16_t value) {
+    buf[i] = value;
+  }
+};
+
+template <uint8_t RES_DIV, class DEPTH>
+class ZBuffer {
+ public:
+  static constexpr uint8_t COLUMNS = SCREEN_WIDTH / RES_DIV;
+
+  // Nothing is closer than the far plane
+  void clear() {
+    memset(buffer, 0xFF, sizeof(buffer));
+  }
+
+  // Store the wall distance for a screen column
+  void set(uint8_t x, uint16_t distance) {
+    DEPTH::write(buffer, x / RES_DIV, DEPTH::encode(distance));
+  }
+
+  // Whether a wall at the screen column is closer than the distance
+  bool hides(uint8_t x, uint16_t distance) {
+    return DEPTH::read(buffer, x / RES_DIV) < DEPTH::encode(distance);
+  }
+
+ private:
+  uint8_t buffer[DEPTH::bytes(COLUMNS)];
+};
+
+#endif